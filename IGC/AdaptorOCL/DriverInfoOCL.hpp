@@ -76,7 +76,7 @@ namespace TC
     {
     public:
         bool SupportsStatelessToStatefullBufferTransformation() const override { return true; }
-        unsigned getVISAPreRASchedulerCtrl() const override { return 6; }
+        unsigned getVISAPreRASchedulerCtrl() const override { return 22; }
         bool SupportStatefulToken() const override { return true; }
         bool SupportInlineAssembly() const override { return true; }
         bool EnableVecAliasing() const override { return true; }
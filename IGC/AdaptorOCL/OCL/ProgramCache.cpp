@@ -0,0 +1,493 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "AdaptorOCL/OCL/ProgramCache.h"
+#include "AdaptorOCL/OCL/sp/gtpin_igc_ocl.h"
+#include "AdaptorCommon/customApi.hpp"
+#include "Compiler/CISACodeGen/Platform.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "ProgramCacheBuildId.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace llvm;
+
+namespace TC
+{
+
+namespace
+{
+    // Bump whenever the entry layout or the key composition changes.
+    const uint32_t ProgramCacheVersion = 3;
+    const uint32_t ProgramCacheMagic = 0x43434749; // "IGCC"
+    const char* const ProgramCacheExt = ".igcbin";
+
+    struct ProgramCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t binarySize;
+        uint64_t debugDataSize;
+        uint64_t buildLogSize;
+    };
+
+    std::string GetProgramCacheDir()
+    {
+        const char* dir = IGC_GET_REGKEYSTRING(ProgramCacheDir);
+        if (dir == nullptr || dir[0] == '\0')
+        {
+            // Regkeys are compiled out of release builds, so honour the
+            // environment variable the debug builds read the key from.
+            dir = getenv("IGC_ProgramCacheDir");
+        }
+        return dir ? dir : "";
+    }
+
+    uint64_t GetProgramCacheMaxSize()
+    {
+        uint64_t sizeMB = IGC_GET_FLAG_VALUE(ProgramCacheMaxSizeMB);
+        if (const char* env = getenv("IGC_ProgramCacheMaxSizeMB"))
+        {
+            sizeMB = strtoull(env, nullptr, 0);
+        }
+        return sizeMB * 1024 * 1024;
+    }
+
+    template <typename T>
+    void HashPOD(MD5& hasher, const T& value)
+    {
+        hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&value), sizeof(T)));
+    }
+
+    void HashBuffer(MD5& hasher, const void* pData, size_t size)
+    {
+        HashPOD(hasher, static_cast<uint64_t>(size));
+        if (pData != nullptr && size != 0)
+        {
+            hasher.update(ArrayRef<uint8_t>(static_cast<const uint8_t*>(pData), size));
+        }
+    }
+
+    // The platform structs are hashed field by field: the driver hands them
+    // over without clearing padding or unused bitfield slack, so their raw
+    // bytes can differ between processes describing the same device.
+    void HashPlatformInfo(MD5& hasher, const PLATFORM& platformInfo)
+    {
+        HashPOD(hasher, platformInfo.eProductFamily);
+        HashPOD(hasher, platformInfo.ePCHProductFamily);
+        HashPOD(hasher, platformInfo.eDisplayCoreFamily);
+        HashPOD(hasher, platformInfo.eRenderCoreFamily);
+#ifndef _COMMON_PPA
+        HashPOD(hasher, platformInfo.ePlatformType);
+#endif
+        HashPOD(hasher, platformInfo.usDeviceID);
+        HashPOD(hasher, platformInfo.usRevId);
+        HashPOD(hasher, platformInfo.usDeviceID_PCH);
+        HashPOD(hasher, platformInfo.usRevId_PCH);
+        HashPOD(hasher, platformInfo.eGTType);
+    }
+
+    // Only the features the compiler reads; everything the WA table is
+    // derived from is covered by hashing the WA table itself.
+    void HashSkuTable(MD5& hasher, const SKU_FEATURE_TABLE& skuTable)
+    {
+#define HASH_SKU_FEATURE(name) HashPOD(hasher, static_cast<uint8_t>(skuTable.name))
+        HASH_SKU_FEATURE(FtrDesktop);
+        HASH_SKU_FEATURE(FtrGtBigDie);
+        HASH_SKU_FEATURE(FtrGtMediumDie);
+        HASH_SKU_FEATURE(FtrGtSmallDie);
+        HASH_SKU_FEATURE(FtrGT1);
+        HASH_SKU_FEATURE(FtrGT1_5);
+        HASH_SKU_FEATURE(FtrGT2);
+        HASH_SKU_FEATURE(FtrGT3);
+        HASH_SKU_FEATURE(FtrGT4);
+        HASH_SKU_FEATURE(FtrGTA);
+        HASH_SKU_FEATURE(FtrGTC);
+        HASH_SKU_FEATURE(FtrGTX);
+        HASH_SKU_FEATURE(Ftr5Slice);
+        HASH_SKU_FEATURE(FtrIVBM0M1Platform);
+        HASH_SKU_FEATURE(FtrSGTPVSKUStrapPresent);
+        HASH_SKU_FEATURE(FtrGpGpuMidThreadLevelPreempt);
+        HASH_SKU_FEATURE(FtrIoMmuPageFaulting);
+        HASH_SKU_FEATURE(FtrWddm2Svm);
+        HASH_SKU_FEATURE(FtrPooledEuEnabled);
+        HASH_SKU_FEATURE(FtrResourceStreamer);
+        HASH_SKU_FEATURE(FtrChannelSwizzlingXOREnabled);
+#undef HASH_SKU_FEATURE
+    }
+
+    void HashGTSystemInfo(MD5& hasher, const GT_SYSTEM_INFO& sysInfo)
+    {
+        HashPOD(hasher, sysInfo.EUCount);
+        HashPOD(hasher, sysInfo.ThreadCount);
+        HashPOD(hasher, sysInfo.SliceCount);
+        HashPOD(hasher, sysInfo.SubSliceCount);
+        HashPOD(hasher, sysInfo.L3CacheSizeInKb);
+        HashPOD(hasher, sysInfo.LLCCacheSizeInKb);
+        HashPOD(hasher, sysInfo.EdramSizeInKb);
+        HashPOD(hasher, sysInfo.L3BankCount);
+        HashPOD(hasher, sysInfo.MaxFillRate);
+        HashPOD(hasher, sysInfo.EuCountPerPoolMax);
+        HashPOD(hasher, sysInfo.EuCountPerPoolMin);
+        HashPOD(hasher, sysInfo.TotalVsThreads);
+        HashPOD(hasher, sysInfo.TotalHsThreads);
+        HashPOD(hasher, sysInfo.TotalDsThreads);
+        HashPOD(hasher, sysInfo.TotalGsThreads);
+        HashPOD(hasher, sysInfo.TotalPsThreadsWindowerRange);
+        HashPOD(hasher, sysInfo.TotalVsThreads_Pocs);
+        HashPOD(hasher, sysInfo.CsrSizeInMb);
+        HashPOD(hasher, sysInfo.MaxEuPerSubSlice);
+        HashPOD(hasher, sysInfo.MaxSlicesSupported);
+        HashPOD(hasher, sysInfo.MaxSubSlicesSupported);
+        HashPOD(hasher, sysInfo.IsL3HashModeEnabled);
+        HashPOD(hasher, sysInfo.IsDynamicallyPopulated);
+    }
+
+#if defined(IGC_DEBUG_VARIABLES)
+    // Any regkey can change the generated code, so every key's value and
+    // shader hash range is part of the cache key. The keys that only
+    // configure the cache itself are left out.
+    void HashRegKey(MD5& hasher, const SRegKeyVariableMetaData& regKey)
+    {
+        const char* name = regKey.GetName();
+        if (strcmp(name, "ProgramCacheDir") == 0 ||
+            strcmp(name, "ProgramCacheMaxSizeMB") == 0 ||
+            strcmp(name, "ProgramCacheVerify") == 0)
+        {
+            return;
+        }
+        HashBuffer(hasher, name, strlen(name));
+        HashBuffer(hasher, regKey.m_string, sizeof(regKey.m_string));
+        HashBuffer(hasher, regKey.hashes.data(), regKey.hashes.size() * sizeof(HashRange));
+    }
+#endif
+
+    void HashDebugState(MD5& hasher)
+    {
+#if defined(IGC_DEBUG_VARIABLES)
+#define DECLARE_IGC_REGKEY(dataType, regkeyName, defaultValue, description) \
+        HashRegKey(hasher, g_RegKeyList.regkeyName);
+#include "common/igc_regkeys.def"
+#undef DECLARE_IGC_REGKEY
+#endif
+        for (int flag = static_cast<int>(IGC::Debug::DebugFlag::BEGIN);
+            flag < static_cast<int>(IGC::Debug::DebugFlag::END); ++flag)
+        {
+            HashPOD(hasher, IGC::Debug::GetDebugFlag(static_cast<IGC::Debug::DebugFlag>(flag)));
+        }
+    }
+
+    bool SameBuffer(const char* pA, uint32_t sizeA, const char* pB, uint32_t sizeB)
+    {
+        return sizeA == sizeB && (sizeA == 0 || memcmp(pA, pB, sizeA) == 0);
+    }
+}
+
+ProgramCache::ProgramCache(
+    const STB_TranslateInputArgs* pInputArgs,
+    TB_DATA_FORMAT inputDataFormat,
+    const IGC::CPlatform& platform,
+    float profilingTimerResolution,
+    const ShaderHash& inputHash)
+    : m_maxSize(0)
+{
+    // Requests for instrumented or traced binaries always go through the
+    // compiler; so do debug sessions that expect dumps or overrides.
+    if (GTPIN_IGC_OCL_IsEnabled() ||
+        pInputArgs->GTPinInput != nullptr ||
+        pInputArgs->TracingOptionsCount != 0 ||
+        pInputArgs->CompileTimeStatisticsEnable ||
+        IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
+        IGC_IS_FLAG_ENABLED(ShaderOverride))
+    {
+        return;
+    }
+
+    // The compiler build: the cache must never hand out a binary produced by
+    // a different compiler, so without a build id there is no cache.
+    const char buildId[] = IGC_PROGRAM_CACHE_BUILD_ID;
+    if (sizeof(buildId) <= 1)
+    {
+        return;
+    }
+
+    m_directory = GetProgramCacheDir();
+    if (m_directory.empty())
+    {
+        return;
+    }
+    if (sys::fs::create_directories(m_directory))
+    {
+        m_directory.clear();
+        return;
+    }
+    m_maxSize = GetProgramCacheMaxSize();
+
+    MD5 hasher;
+    HashPOD(hasher, ProgramCacheVersion);
+    HashBuffer(hasher, buildId, sizeof(buildId));
+    const char llvmVersion[] = LLVM_VERSION_STRING;
+    HashBuffer(hasher, llvmVersion, sizeof(llvmVersion));
+    HashDebugState(hasher);
+
+    HashPOD(hasher, inputDataFormat);
+    HashBuffer(hasher, pInputArgs->pInput, pInputArgs->InputSize);
+    HashBuffer(hasher, pInputArgs->pOptions, pInputArgs->OptionsSize);
+    HashBuffer(hasher, pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize);
+    HashBuffer(hasher, pInputArgs->pSpecConstantsIds,
+        pInputArgs->SpecConstantsSize * sizeof(*pInputArgs->pSpecConstantsIds));
+    HashBuffer(hasher, pInputArgs->pSpecConstantsValues,
+        pInputArgs->SpecConstantsSize * sizeof(*pInputArgs->pSpecConstantsValues));
+    HashPOD(hasher, profilingTimerResolution);
+
+    HashPlatformInfo(hasher, platform.getPlatformInfo());
+    HashSkuTable(hasher, platform.getSkuTable());
+    // SetWorkaroundTable clears the WA table before filling it in, so its
+    // bytes are deterministic and can be hashed as a whole.
+    HashPOD(hasher, platform.getWATable());
+    HashGTSystemInfo(hasher, platform.GetGTSystemInfo());
+
+    MD5::MD5Result result;
+    hasher.final(result);
+    SmallString<32> digest;
+    MD5::stringifyResult(result, digest);
+
+    // Lead with the same hash the shader dumps are named after, so an entry
+    // can be matched to its dumps by eye.
+    char asmHash[17];
+    snprintf(asmHash, sizeof(asmHash), "%016llx", (unsigned long long)inputHash.getAsmHash());
+
+    SmallString<256> path(m_directory);
+    sys::path::append(path, Twine(asmHash) + "_" + digest + ProgramCacheExt);
+    m_entryPath = path.str().str();
+}
+
+bool ProgramCache::load(STB_TranslateOutputArgs* pOutputArgs) const
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+
+    int fd = -1;
+    if (sys::fs::openFileForRead(m_entryPath, fd))
+    {
+        return false;
+    }
+    auto bufferOrErr = MemoryBuffer::getOpenFile(fd, m_entryPath, -1);
+    if (!bufferOrErr)
+    {
+        sys::Process::SafelyCloseFileDescriptor(fd);
+        return false;
+    }
+    // Refresh the entry's timestamp; eviction drops the stalest entries first.
+#if LLVM_VERSION_MAJOR >= 8
+    sys::fs::setLastAccessAndModificationTime(fd, std::chrono::system_clock::now());
+#else
+    sys::fs::setLastModificationAndAccessTime(fd, std::chrono::system_clock::now());
+#endif
+    sys::Process::SafelyCloseFileDescriptor(fd);
+
+    const MemoryBuffer& buffer = *bufferOrErr.get();
+    ProgramCacheHeader header;
+    if (buffer.getBufferSize() < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, buffer.getBufferStart(), sizeof(header));
+    if (header.magic != ProgramCacheMagic ||
+        header.version != ProgramCacheVersion ||
+        header.binarySize == 0 ||
+        buffer.getBufferSize() !=
+            sizeof(header) + header.binarySize + header.debugDataSize + header.buildLogSize)
+    {
+        return false;
+    }
+
+    const char* pData = buffer.getBufferStart() + sizeof(header);
+    char* binaryOutput = new char[header.binarySize];
+    memcpy(binaryOutput, pData, header.binarySize);
+    pOutputArgs->OutputSize = static_cast<uint32_t>(header.binarySize);
+    pOutputArgs->pOutput = binaryOutput;
+
+    if (header.debugDataSize > 0)
+    {
+        char* debugDataOutput = new char[header.debugDataSize];
+        memcpy(debugDataOutput, pData + header.binarySize, header.debugDataSize);
+        pOutputArgs->DebugDataSize = static_cast<uint32_t>(header.debugDataSize);
+        pOutputArgs->pDebugData = debugDataOutput;
+    }
+
+    // Warnings of the original build are reported again, as a compile would.
+    if (header.buildLogSize > 0)
+    {
+        char* buildLogOutput = new char[header.buildLogSize];
+        memcpy(buildLogOutput, pData + header.binarySize + header.debugDataSize, header.buildLogSize);
+        pOutputArgs->ErrorStringSize = static_cast<uint32_t>(header.buildLogSize);
+        pOutputArgs->pErrorString = buildLogOutput;
+    }
+    return true;
+}
+
+void ProgramCache::store(
+    const char* pBinary, size_t binarySize,
+    const char* pDebugData, size_t debugDataSize,
+    const char* pBuildLog, size_t buildLogSize) const
+{
+    if (!isEnabled() || pBinary == nullptr || binarySize == 0)
+    {
+        return;
+    }
+
+    // Write into a private temporary and rename it into place so readers in
+    // other processes never observe a partially written entry.
+    int fd = -1;
+    SmallString<256> tmpPath;
+    SmallString<256> model(m_directory);
+    sys::path::append(model, "tmp-%%%%%%%%%%%%");
+    if (sys::fs::createUniqueFile(model, fd, tmpPath))
+    {
+        return;
+    }
+
+    ProgramCacheHeader header;
+    header.magic = ProgramCacheMagic;
+    header.version = ProgramCacheVersion;
+    header.binarySize = binarySize;
+    header.debugDataSize = pDebugData ? debugDataSize : 0;
+    header.buildLogSize = pBuildLog ? buildLogSize : 0;
+
+    bool failed = false;
+    {
+        raw_fd_ostream os(fd, /*shouldClose=*/true);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(pBinary, binarySize);
+        if (header.debugDataSize > 0)
+        {
+            os.write(pDebugData, debugDataSize);
+        }
+        if (header.buildLogSize > 0)
+        {
+            os.write(pBuildLog, buildLogSize);
+        }
+        os.close();
+        failed = os.has_error();
+        os.clear_error();
+    }
+
+    if (failed || sys::fs::rename(tmpPath, m_entryPath))
+    {
+        sys::fs::remove(tmpPath);
+        return;
+    }
+
+    evict();
+}
+
+bool ProgramCache::verify(
+    const STB_TranslateOutputArgs& pCachedArgs,
+    const STB_TranslateOutputArgs& pOutputArgs)
+{
+    return
+        SameBuffer(pCachedArgs.pOutput, pCachedArgs.OutputSize,
+            pOutputArgs.pOutput, pOutputArgs.OutputSize) &&
+        SameBuffer(pCachedArgs.pDebugData, pCachedArgs.DebugDataSize,
+            pOutputArgs.pDebugData, pOutputArgs.DebugDataSize) &&
+        SameBuffer(pCachedArgs.pErrorString, pCachedArgs.ErrorStringSize,
+            pOutputArgs.pErrorString, pOutputArgs.ErrorStringSize);
+}
+
+void ProgramCache::evict() const
+{
+    if (m_maxSize == 0)
+    {
+        return;
+    }
+
+    struct Entry
+    {
+        std::string path;
+        sys::TimePoint<> lastUse;
+        uint64_t size;
+    };
+    std::vector<Entry> entries;
+    uint64_t totalSize = 0;
+
+    std::error_code ec;
+    for (sys::fs::directory_iterator it(m_directory, ec), end; it != end && !ec; it.increment(ec))
+    {
+        if (sys::path::extension(it->path()) != ProgramCacheExt)
+        {
+            continue;
+        }
+        sys::fs::file_status status;
+        if (sys::fs::status(it->path(), status))
+        {
+            continue;
+        }
+        entries.push_back({ it->path(), status.getLastModificationTime(), status.getSize() });
+        totalSize += status.getSize();
+    }
+
+    if (totalSize <= m_maxSize)
+    {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUse < b.lastUse;
+    });
+    for (const Entry& entry : entries)
+    {
+        if (totalSize <= m_maxSize)
+        {
+            break;
+        }
+        // Another process may have evicted the entry already; either way it
+        // no longer counts against the budget.
+        sys::fs::remove(entry.path);
+        totalSize -= entry.size;
+    }
+}
+
+} // namespace TC
@@ -0,0 +1,88 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#pragma once
+
+#include "AdaptorOCL/TranslationBlock.h"
+#include "common/Types.hpp"
+
+#include <string>
+
+namespace IGC
+{
+    class CPlatform;
+}
+
+namespace TC
+{
+
+/// ProgramCache - persistent on-disk cache of OCL program binaries.
+///
+/// Entries are content addressed: the key covers the input module, the build
+/// options, the spec constants, the platform (SKU/WA tables, GT system info),
+/// the regkeys and debug flags in effect and the compiler build. The cache is
+/// enabled by pointing the ProgramCacheDir regkey (or the IGC_ProgramCacheDir
+/// environment variable in release builds) at a writable directory. Entries
+/// are published with an atomic rename, so concurrent processes sharing the
+/// directory only ever see complete files, and the directory is kept under
+/// ProgramCacheMaxSizeMB by evicting the least recently used entries.
+class ProgramCache
+{
+public:
+    ProgramCache(
+        const STB_TranslateInputArgs* pInputArgs,
+        TB_DATA_FORMAT inputDataFormat,
+        const IGC::CPlatform& platform,
+        float profilingTimerResolution,
+        const ShaderHash& inputHash);
+
+    bool isEnabled() const { return !m_entryPath.empty(); }
+
+    /// load - on a hit, fills the program binary, debug data and build log
+    /// of pOutputArgs the same way a full compile would and returns true.
+    bool load(STB_TranslateOutputArgs* pOutputArgs) const;
+
+    /// store - publishes a freshly compiled program and trims the cache.
+    void store(
+        const char* pBinary, size_t binarySize,
+        const char* pDebugData, size_t debugDataSize,
+        const char* pBuildLog, size_t buildLogSize) const;
+
+    /// verify - checks that the entry loaded into pCachedArgs is identical to
+    /// the freshly compiled pOutputArgs (ProgramCacheVerify).
+    static bool verify(
+        const STB_TranslateOutputArgs& pCachedArgs,
+        const STB_TranslateOutputArgs& pOutputArgs);
+
+private:
+    void evict() const;
+
+    std::string m_directory;
+    std::string m_entryPath;
+    uint64_t m_maxSize;
+};
+
+} // namespace TC
@@ -0,0 +1,62 @@
+#===================== begin_copyright_notice ==================================
+
+#Copyright (c) 2017 Intel Corporation
+
+#Permission is hereby granted, free of charge, to any person obtaining a
+#copy of this software and associated documentation files (the
+#"Software"), to deal in the Software without restriction, including
+#without limitation the rights to use, copy, modify, merge, publish,
+#distribute, sublicense, and/or sell copies of the Software, and to
+#permit persons to whom the Software is furnished to do so, subject to
+#the following conditions:
+
+#The above copyright notice and this permission notice shall be included
+#in all copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+#MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+#IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+#CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+#TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+#SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+# Generates the header that identifies the compiler build for the persistent
+# program cache. The id is the commit the compiler is built from plus a digest
+# of any uncommitted changes, so a rebuilt compiler never picks up entries
+# produced by a different one. Without git the id is left empty and the cache
+# stays disabled.
+#
+# Inputs: GIT_EXECUTABLE, SOURCE_DIR, OUTPUT.
+
+set(_buildId "")
+if(GIT_EXECUTABLE)
+  execute_process(
+      COMMAND "${GIT_EXECUTABLE}" rev-parse HEAD
+      WORKING_DIRECTORY "${SOURCE_DIR}"
+      RESULT_VARIABLE _gitResult
+      OUTPUT_VARIABLE _gitCommit
+      ERROR_QUIET
+      OUTPUT_STRIP_TRAILING_WHITESPACE
+    )
+  if(_gitResult EQUAL 0)
+    set(_buildId "${_gitCommit}")
+    execute_process(
+        COMMAND "${GIT_EXECUTABLE}" diff HEAD
+        WORKING_DIRECTORY "${SOURCE_DIR}"
+        OUTPUT_VARIABLE _gitDiff
+        ERROR_QUIET
+      )
+    if(NOT _gitDiff STREQUAL "")
+      string(MD5 _gitDiffHash "${_gitDiff}")
+      set(_buildId "${_buildId}-${_gitDiffHash}")
+    endif()
+  endif()
+endif()
+
+file(WRITE "${OUTPUT}.tmp" "#define IGC_PROGRAM_CACHE_BUILD_ID \"${_buildId}\"\n")
+# Only touch the header when the id changes, so unchanged builds don't recompile.
+execute_process(COMMAND "${CMAKE_COMMAND}" -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -97,6 +97,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/Optimizer/OpenCLPasses/BreakdownIntrinsic.h"
 #include "Compiler/Optimizer/OpenCLPasses/StatelessToStatefull/StatelessToStatefull.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/KernelFunctionCloning.h"
+#include "Compiler/Optimizer/OpenCLPasses/KernelRetryFilter.h"
 #include "Compiler/Legalizer/TypeLegalizerPass.h"
 #include "Compiler/Optimizer/OpenCLPasses/ClampLoopUnroll/ClampLoopUnroll.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/Image3dToImage2darray/Image3dToImage2darray.hpp"
@@ -375,6 +376,17 @@ static void CommonOCLBasedPasses(
     mpm.add(new OpenCLPrintfAnalysis());
     mpm.add(createDeadCodeEliminationPass());
     mpm.add(new ProgramScopeConstantAnalysis());
+
+    // On a retry, only the kernels that spilled are compiled again. Drop the
+    // others once the program-scope buffers above have been laid out.
+    if (!pContext->m_retryManager.IsFirstTry() &&
+        !pContext->m_retryManager.kernelSet.empty())
+    {
+        mpm.add(createKernelRetryFilterPass());
+        mpm.add(createGlobalDCEPass());
+        mpm.add(new PurgeMetaDataUtils());
+    }
+
     mpm.add(new PrivateMemoryUsageAnalysis());
     mpm.add(new AggregateArgumentsAnalysis());
     mpm.add(new ExtensionFuncsAnalysis());
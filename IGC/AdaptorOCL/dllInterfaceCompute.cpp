@@ -35,9 +35,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <string>
 #include <stdexcept>
 #include <fstream>
+#include <memory>
 
 #include "AdaptorCommon/customApi.hpp"
 #include "AdaptorOCL/OCL/LoadBuffer.h"
+#include "AdaptorOCL/OCL/ProgramCache.h"
 #include "AdaptorOCL/OCL/BuiltinResource.h"
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
 
@@ -773,6 +775,25 @@ bool TranslateBuild(
         IGC::Debug::SetDebugFlag(IGC::Debug::DebugFlag::SHADER_QUALITY_METRICS, true);
     }
     
+    ShaderHash inputShHash = ShaderHashOCL((const UINT*)pInputArgs->pInput, pInputArgs->InputSize / 4);
+
+    // A program built earlier with the same input, options and platform can
+    // be handed back without running the compiler at all.
+    ProgramCache programCache(pInputArgs, inputDataFormatTemp, IGCPlatform, profilingTimerResolution, inputShHash);
+    // With ProgramCacheVerify a hit is compiled anyway and checked against the
+    // fresh result below.
+    STB_TranslateOutputArgs cachedOutputArgs;
+    bool verifyProgramCache = IGC_IS_FLAG_ENABLED(ProgramCacheVerify);
+    if (programCache.load(verifyProgramCache ? &cachedOutputArgs : pOutputArgs) && !verifyProgramCache)
+    {
+        return true;
+    }
+    // The cached copy is only compared against, so it is released on every
+    // path out of the build, including the early error returns.
+    std::unique_ptr<char[]> cachedOutput(cachedOutputArgs.pOutput);
+    std::unique_ptr<char[]> cachedDebugData(cachedOutputArgs.pDebugData);
+    std::unique_ptr<char[]> cachedErrorString(cachedOutputArgs.pErrorString);
+
     MEM_USAGERESET;
 
     // Parse the module we want to compile
@@ -780,8 +801,6 @@ bool TranslateBuild(
     LLVMContextWrapper* llvmContext = new LLVMContextWrapper;
     RegisterComputeErrHandlers(*llvmContext);
 
-    ShaderHash inputShHash = ShaderHashOCL((const UINT*)pInputArgs->pInput, pInputArgs->InputSize / 4);
-
     if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
     {
         const char *pOutputFolder = IGC::Debug::GetShaderOutputFolder();
@@ -1068,6 +1087,19 @@ bool TranslateBuild(
         pOutputArgs->pDebugData = debugDataOutput;
     }
 
+    if (cachedOutputArgs.pOutput != nullptr)
+    {
+        if (!ProgramCache::verify(cachedOutputArgs, *pOutputArgs))
+        {
+            SetErrorMessage("Program cache entry differs from the compiled program", *pOutputArgs);
+            return false;
+        }
+    }
+
+    programCache.store(binaryOutput, binarySize,
+        debugDataSize > 0 ? pOutputArgs->pDebugData : nullptr, debugDataSize,
+        pOutputArgs->pErrorString, pOutputArgs->ErrorStringSize);
+
     const char* driverName =
         GTPIN_DRIVERVERSION_OPEN;
     // If GT-Pin is enabled, instrument the binary. Finally pOutputArgs will 
@@ -305,7 +305,9 @@ CEncoder::CEncoder()
 {
     m_program = nullptr;
     vbuilder = nullptr;
-    vAsmTextBuilder = nullptr;
+    m_pCompiledKernel = nullptr;
+    m_compileStatus = 0;
+    m_compileWithSymbolTable = false;
 }
 
 CEncoder::~CEncoder()
@@ -3964,22 +3966,18 @@ void CEncoder::InitEncoder( bool canAbortOnSpill, bool hasStackCall )
     m_hasInlineAsm = context->m_DriverInfo.SupportInlineAssembly() && context->m_instrTypes.hasInlineAsm;
 
     vbuilder = nullptr;
-    vAsmTextBuilder = nullptr;
     TARGET_PLATFORM VISAPlatform = GetVISAPlatform(&(context->platform));
 
     SetVISAWaTable(m_program->m_Platform->getWATable());
 
     llvm::SmallVector<const char*, 10> params;
-    if (!m_hasInlineAsm)
-    {
-        // Asm text writer mode doesnt need dump params
-        InitBuildParams(params);
-    }
+    InitBuildParams(params);
 
     bool enableVISADump = IGC_IS_FLAG_ENABLED(EnableVISASlowpath) || IGC_IS_FLAG_ENABLED(ShaderDumpEnable);
-    auto builderMode = m_hasInlineAsm ? vISA_ASM_WRITER : vISA_3D;
+    // inline asm is parsed straight into the kernel and refers to its
+    // variables by name, which needs the vISA variable tables
     auto builderOpt = (enableVISADump || m_hasInlineAsm) ? CM_CISA_BUILDER_BOTH : CM_CISA_BUILDER_GEN;
-    V(CreateVISABuilder(vbuilder, builderMode, builderOpt, VISAPlatform, params.size(), params.data(), &m_WaTable));
+    V(CreateVISABuilder(vbuilder, vISA_3D, builderOpt, VISAPlatform, params.size(), params.data(), &m_WaTable));
 
     InitVISABuilderOptions(VISAPlatform, canAbortOnSpill, hasStackCall);
 
@@ -4414,10 +4412,17 @@ void CEncoder::CreateRelocationTable(void*& buffer, unsigned& bufferSize, unsign
 
 void CEncoder::Compile(bool hasSymbolTable)
 {
-    COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISAEmitPass);
+    BeginCompile(hasSymbolTable, false);
+    EndCompile();
+}
 
-    CodeGenContext* context = m_program->GetContext();
-    SProgramOutput* pOutput = m_program->ProgramOutput();
+// Start the vISA compile of this kernel. With async, the vISA back end runs on a
+// separate thread; EndCompile() waits for it and collects the results. Only the
+// vISA builders of this encoder are touched by that thread, so other encoders
+// may keep emitting vISA in the meantime.
+void CEncoder::BeginCompile(bool hasSymbolTable, bool async)
+{
+    COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISAEmitPass);
 
     if( m_program->m_dispatchSize == SIMDMode::SIMD8 )
     {
@@ -4436,37 +4441,56 @@ void CEncoder::Compile(bool hasSymbolTable)
 
     COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISACompile);
 
-    int vIsaCompile = 0;
-    VISAKernel* pMainKernel = nullptr;
+    VISABuilder* pCompileBuilder = vbuilder;
+    m_pCompiledKernel = vMainKernel;
+    m_compileWithSymbolTable = hasSymbolTable;
 
-    // Compile generated VISA text string for inlineAsm
-    if (m_hasInlineAsm)
+    //Compile to generate the V-ISA binary
+    std::string isaFileName = m_enableVISAdump ? GetDumpFileName("isa") : "";
+    if (async)
     {
-        // Finalize the text builder by writing the header
-        V(vbuilder->WriteVISAHeader());
-
-        llvm::SmallVector<const char*, 10> params;
-        InitBuildParams(params);
+        // vISA keeps its timers in thread-local storage, so the worker reads
+        // them itself before it finishes; EndCompile records them after the join.
+        bool readVISATimers = false;
+#if GET_TIME_STATS
+        readVISATimers = m_program->GetContext()->m_compilerTimeStats != nullptr;
+#endif
+        std::vector<int64_t>* pVISATimers = &m_pendingVISATimers;
+        pVISATimers->clear();
+        m_pendingCompile = std::async(std::launch::async,
+            [pCompileBuilder, isaFileName, readVISATimers, pVISATimers]()
+        {
+            int status = pCompileBuilder->Compile(isaFileName.c_str());
+#if GET_TIME_STATS
+            if (readVISATimers)
+            {
+                *pVISATimers = TimeStats::readVISATimers();
+            }
+#endif
+            return status;
+        });
+    }
+    else
+    {
+        m_compileStatus = pCompileBuilder->Compile(isaFileName.c_str());
+    }
+    COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
+}
 
-        // Create a new builder for parsing the visaasm
-        TARGET_PLATFORM VISAPlatform = GetVISAPlatform(&(context->platform));
-        V(CreateVISABuilder(vAsmTextBuilder, vISA_ASM_READER, CM_CISA_BUILDER_BOTH, VISAPlatform, params.size(), params.data(), &m_WaTable));
-        // Use the same build options as before
-        SetBuilderOptions(vAsmTextBuilder);
+void CEncoder::EndCompile()
+{
+    CodeGenContext* context = m_program->GetContext();
+    SProgramOutput* pOutput = m_program->ProgramOutput();
 
-        // Parse the generated VISA text
-        std::string parseTextFile = m_enableVISAdump ? GetDumpFileName("inline.visaasm") : "";
-        V(vAsmTextBuilder->ParseVISAText(vbuilder->GetAsmTextHeaderStream().str(), vbuilder->GetAsmTextStream().str(), parseTextFile));
+    COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISACompile);
 
-        pMainKernel = vAsmTextBuilder->GetVISAKernel();
-        vIsaCompile = vAsmTextBuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
-    }
-    //Compile to generate the V-ISA binary
-    else
+    bool compiledAsync = m_pendingCompile.valid();
+    if (compiledAsync)
     {
-        pMainKernel = vMainKernel;
-        vIsaCompile = vbuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
+        m_compileStatus = m_pendingCompile.get();
     }
+    int vIsaCompile = m_compileStatus;
+    VISAKernel* pMainKernel = m_pCompiledKernel;
 
     FINALIZER_INFO *jitInfo;
     pMainKernel->GetJitInfo(jitInfo);
@@ -4485,7 +4509,14 @@ void CEncoder::Compile(bool hasSymbolTable)
     // handle the vISA time counters differently here
     if (context->m_compilerTimeStats)
     {
-        context->m_compilerTimeStats->recordVISATimers();
+        if (compiledAsync)
+        {
+            context->m_compilerTimeStats->recordVISATimers(m_pendingVISATimers);
+        }
+        else
+        {
+            context->m_compilerTimeStats->recordVISATimers();
+        }
     }
 #endif
 
@@ -4658,7 +4689,7 @@ void CEncoder::Compile(bool hasSymbolTable)
 
     pMainKernel->GetGTPinBuffer(pOutput->m_gtpinBuffer, pOutput->m_gtpinBufferSize);
 
-    if (hasSymbolTable)
+    if (m_compileWithSymbolTable)
     {
         CreateSymbolTable(pOutput->m_funcSymbolTable,
             pOutput->m_funcSymbolTableSize,
@@ -4684,11 +4715,6 @@ void CEncoder::Compile(bool hasSymbolTable)
 
 void CEncoder::DestroyVISABuilder()
 {
-    if (vAsmTextBuilder != nullptr)
-    {
-        V(::DestroyVISABuilder(vAsmTextBuilder));
-        vAsmTextBuilder = nullptr;
-    }
     V(::DestroyVISABuilder(vbuilder));
     vbuilder = nullptr;
 }
@@ -5618,6 +5644,12 @@ void CEncoder::Lifetime(VISAVarLifetime StartOrEnd, CVariable* dst)
     V(vKernel->AppendVISALifetime(StartOrEnd, srcOpnd));
 }
 
+// Parse vISA asm text (see GetVariableName()) into the current kernel.
+void CEncoder::InlineAsm(const std::string& asmText)
+{
+    V(vbuilder->ParseInlineVISAText(vKernel, asmText));
+}
+
 
 std::string CEncoder::GetVariableName(CVariable* var)
 {
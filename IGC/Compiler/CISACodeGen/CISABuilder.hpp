@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/helper.h"
 
 #include "visa_wa.h"
+#include <future>
 
 namespace IGC
 {
@@ -145,6 +146,11 @@ public:
     void DeclareInput(CVariable* var, uint offset, uint instance);
     void MarkAsOutput(CVariable* var);
     void Compile(bool hasSymbolTable = false);
+    /// Compile() split in two, so that the vISA back end of several encoders can
+    /// run concurrently (see EnableParallelSIMDCodeGen).
+    void BeginCompile(bool hasSymbolTable, bool async);
+    void EndCompile();
+    bool HasPendingCompile() const { return m_pendingCompile.valid(); }
     CEncoder();
     ~CEncoder();
     void SetProgram(CShader* program);
@@ -288,6 +294,7 @@ public:
     void SubPair(CVariable *Lo, CVariable *Hi, CVariable *L0, CVariable *H0, CVariable *L1, CVariable *H1);
     inline void dp4a(CVariable* dst, CVariable* src0, CVariable* src1, CVariable* src2);
     void Lifetime(VISAVarLifetime StartOrEnd, CVariable* dst);
+    void InlineAsm(const std::string& asmText);
     // VME
     void SendVmeIme(
         CVariable* bindingTableIndex,
@@ -547,10 +554,17 @@ protected:
     VISAKernel*   vKernel;
     VISAKernel*   vMainKernel;
     VISABuilder* vbuilder;
-    VISABuilder* vAsmTextBuilder;
 
     bool m_enableVISAdump;
     bool m_hasInlineAsm;
+
+    /// State of a compile between BeginCompile and EndCompile
+    std::future<int> m_pendingCompile;
+    /// vISA timers read by the thread of the pending compile
+    std::vector<int64_t> m_pendingVISATimers;
+    int m_compileStatus;
+    VISAKernel* m_pCompiledKernel;
+    bool m_compileWithSymbolTable;
     std::vector<VISA_LabelOpnd*> labelMap;
 
     /// Per kernel label counter
@@ -1927,10 +1927,11 @@ CVariable* CShader::LazyCreateCCTupleBackingVariable(
 /// In some sense, all formal arguments are pre-allocated. Those symbols must be
 /// non-alias cvariable (ie root cvariable) as required by visa.
 ///
-/// Currently, all explicit arguments are non-uniform and most implicit
-/// arguments are uniform. Some implicit arguments may share the same symbol
-/// with their caller's implicit argument of the same kind. This is a subroutine
-/// optimization implemented in 'getOrCreateArgumentSymbol'.
+/// Explicit arguments are non-uniform, unless WIAnalysis finds them uniform at
+/// all call sites of a subroutine, and most implicit arguments are uniform.
+/// Some implicit arguments may share the same symbol with their caller's
+/// implicit argument of the same kind. This is a subroutine optimization
+/// implemented in 'getOrCreateArgumentSymbol'.
 ///
 void CShader::BeginFunction(llvm::Function *F)
 {
@@ -2104,16 +2105,22 @@ CVariable* CShader::getOrCreateArgumentSymbol(
             // Arg is for the current function and m_WI is available
             isUniform = (m_WI->whichDepend(&*Arg) == WIAnalysis::UNIFORM);
         }
+        else if (!useStackCall) {
+            // Arg is for a subroutine called from the current function. It
+            // must match what WIAnalysis finds when analyzing the callee.
+            isUniform = m_WI->isUniformSubroutineArg(Arg);
+        }
 
         VISA_Type type = GetType(Arg->getType());
-        uint16_t nElts = numLanes(m_SIMDSize);
+        uint16_t nElts = isUniform ? 1 : numLanes(m_SIMDSize);
         if (Arg->getType()->isVectorTy())
         {
             assert(Arg->getType()->getVectorElementType()->isIntegerTy() ||
                 Arg->getType()->getVectorElementType()->isFloatingPointTy());
             nElts *= (uint16_t)Arg->getType()->getVectorNumElements();
         }
-        var = GetNewVariable(nElts, type, align, isUniform, m_numberInstance);
+        var = GetNewVariable(nElts, type, align, isUniform,
+            isUniform ? 1 : m_numberInstance);
     }
     pSymMap->insert(std::make_pair(Arg, var));
     return var;
@@ -56,7 +56,7 @@ using namespace std;
 
 char EmitPass::ID = 0;
 
-EmitPass::EmitPass(CShaderProgram::KernelShaderMap &shaders, SIMDMode mode, bool canAbortOnSpill, ShaderDispatchMode shaderMode, PSSignature* pSignature)
+EmitPass::EmitPass(CShaderProgram::KernelShaderMap &shaders, SIMDMode mode, bool canAbortOnSpill, ShaderDispatchMode shaderMode, PSSignature* pSignature, bool asyncVISACompile)
     : FunctionPass(ID),
     m_SimdMode(mode),
     m_ShaderMode(shaderMode),
@@ -64,6 +64,7 @@ EmitPass::EmitPass(CShaderProgram::KernelShaderMap &shaders, SIMDMode mode, bool
     m_currShader(nullptr),
     m_encoder(nullptr),
     m_canAbortOnSpill(canAbortOnSpill),
+    m_asyncVISACompile(asyncVISACompile),
     m_roundingMode(CEncoder::RoundingMode::RoundToNearestEven),
     m_pSignature(pSignature)
 {
@@ -702,19 +703,16 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         // We only need one symbol table per module. If there are multiple kernels, only create a symbol
         // table for the default one set by FGA
         bool compileWithSymbolTable = !m_FGA || (m_FGA->getGroup(&F)->getHead() == m_FGA->getDefaultKernel());
-        m_encoder->Compile(compileWithSymbolTable);
-        // if we are doing stack-call, do the following:
-        // - Hard-code a large scratch-space for visa
-        if (hasStackCall || hasFunctionPointer)
+        if (m_asyncVISACompile && !m_currShader->diData)
         {
-            if (m_currShader->ProgramOutput()->m_scratchSpaceUsedBySpills == 0)
-            {
-                // Don't retry if we didn't spill
-                ctx->m_retryManager.Disable();
-            }
-            m_currShader->ProgramOutput()->m_scratchSpaceUsedBySpills =
-                MAX(m_currShader->ProgramOutput()->m_scratchSpaceUsedBySpills, 32 * 1024);
+            // Results are collected by VISACompileJoinPass once all SIMD variants
+            // of this kernel have been emitted.
+            m_encoder->BeginCompile(compileWithSymbolTable, true);
+            IF_DEBUG_INFO(IDebugEmitter::Release(m_pDebugEmitter);)
+            return false;
         }
+        m_encoder->Compile(compileWithSymbolTable);
+        FinishCompile(m_currShader, m_FGA, &F);
     }
 
     if (destroyVISABuilder)
@@ -729,25 +727,92 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         }
     }
 
-    if ((m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
-        m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
-        m_currShader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
+    UpdateMidThreadPreemption(m_currShader);
+
+    return false;
+}
+
+// Update the program output once the vISA compile of a kernel has finished.
+// F is the last function of the kernel's function group.
+void EmitPass::FinishCompile(CShader* shader, GenXFunctionGroupAnalysis* FGA, llvm::Function* F)
+{
+    CodeGenContext* ctx = shader->GetContext();
+    bool hasStackCall = FGA && FGA->getGroup(F)->hasStackCall();
+    bool hasFunctionPointer = ctx->m_instrTypes.hasIndirectCall || (FGA && FGA->getGroup(F)->hasExternFCall());
+
+    // if we are doing stack-call, do the following:
+    // - Hard-code a large scratch-space for visa
+    if (hasStackCall || hasFunctionPointer)
+    {
+        if (shader->ProgramOutput()->m_scratchSpaceUsedBySpills == 0)
+        {
+            // Don't retry if we didn't spill
+            ctx->m_retryManager.Disable();
+        }
+        shader->ProgramOutput()->m_scratchSpaceUsedBySpills =
+            MAX(shader->ProgramOutput()->m_scratchSpaceUsedBySpills, 32 * 1024);
+    }
+}
+
+void EmitPass::UpdateMidThreadPreemption(CShader* shader)
+{
+    if ((shader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
+        shader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
+        shader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
         IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
-        (m_currShader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
-        (m_currShader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
+        (shader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
+        (shader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
     {
-        if (m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER)
+        if (shader->GetShaderType() == ShaderType::COMPUTE_SHADER)
         {
-            CComputeShader* csProgram = static_cast<CComputeShader*>(m_currShader);
+            CComputeShader* csProgram = static_cast<CComputeShader*>(shader);
             csProgram->SetDisableMidthreadPreemption();
         }
         else
         {
-            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(m_currShader);
+            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(shader);
             kernel->SetDisableMidthreadPreemption();
         }
     }
+}
+
+char VISACompileJoinPass::ID = 0;
+
+VISACompileJoinPass::VISACompileJoinPass(CShaderProgram::KernelShaderMap &shaders)
+    : FunctionPass(ID), m_shaders(shaders)
+{
+}
+
+bool VISACompileJoinPass::runOnFunction(llvm::Function &F)
+{
+    GenXFunctionGroupAnalysis* FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
+    if (FGA && !FGA->isGroupTail(&F))
+    {
+        return false;
+    }
 
+    llvm::Function* kernelFunc = FGA ? FGA->getGroup(&F)->getHead() : &F;
+    auto programIt = m_shaders.find(kernelFunc);
+    if (programIt == m_shaders.end())
+    {
+        return false;
+    }
+
+    // Collect the results in a fixed order, independently of which compile
+    // finishes first, so the RetryManager and program outputs are updated in
+    // the same order for every build.
+    const SIMDMode simdModes[] = { SIMDMode::SIMD8, SIMDMode::SIMD16, SIMDMode::SIMD32 };
+    for (SIMDMode simdMode : simdModes)
+    {
+        CShader* shader = programIt->second->GetShader(simdMode);
+        if (shader && shader->GetEncoder().HasPendingCompile())
+        {
+            shader->GetEncoder().EndCompile();
+            EmitPass::FinishCompile(shader, FGA, &F);
+            shader->GetEncoder().DestroyVISABuilder();
+            EmitPass::UpdateMidThreadPreemption(shader);
+        }
+    }
     return false;
 }
 
@@ -7748,9 +7813,11 @@ bool EmitPass::validateInlineAsmConstraints(llvm::CallInst* inst)
 
 // Parse the inlined asm string to generate VISA operands
 // Example: "mul (M1, 16) $0(0, 0)<1> $1(0, 0)<1;1,0> $2(0, 0)<1;1,0>", "=r,r,r"(float %6, float %7)
+// The operands are replaced by the vISA variable names and the resulting text
+// is parsed directly into the current vISA kernel.
 void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
 {
-    std::stringstream &str = m_encoder->GetVISABuilder()->GetAsmTextStream();
+    std::stringstream str;
     InlineAsm* IA = cast<InlineAsm>(inst->getCalledValue());
     const char* asmStr = IA->getAsmString().c_str();
     const char* lastEmitted = asmStr;
@@ -7819,6 +7886,8 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
     }
     if (str.str().back() != '\n') str << endl;
     str << "/// End Inlined ASM" << endl << endl;
+
+    m_encoder->InlineAsm(str.str());
 }
 
 CVariable *EmitPass::Mul(CVariable *Src0, CVariable *Src1, const CVariable *DstPrototype)
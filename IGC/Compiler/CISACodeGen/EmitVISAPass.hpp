@@ -54,7 +54,7 @@ struct PSSignature;
 class EmitPass : public llvm::FunctionPass
 {
 public:
-    EmitPass(CShaderProgram::KernelShaderMap &shaders, SIMDMode mode, bool canAbortOnSpill, ShaderDispatchMode shaderMode, PSSignature* pSignature = nullptr);
+    EmitPass(CShaderProgram::KernelShaderMap &shaders, SIMDMode mode, bool canAbortOnSpill, ShaderDispatchMode shaderMode, PSSignature* pSignature = nullptr, bool asyncVISACompile = false);
 
     virtual ~EmitPass();
 
@@ -78,6 +78,8 @@ public:
     virtual llvm::StringRef getPassName() const  override { return "EmitPass"; }
 
     void CreateKernelShaderMap(CodeGenContext *ctx, IGC::IGCMD::MetaDataUtils *pMdUtils, llvm::Function &F);
+    static void FinishCompile(CShader* shader, GenXFunctionGroupAnalysis* FGA, llvm::Function* F);
+    static void UpdateMidThreadPreemption(CShader* shader);
 
     void Frc(const SSource& source, const DstModifier& modifier);
     void Mad(const SSource sources[3], const DstModifier& modifier);
@@ -498,6 +500,9 @@ public:
     ModuleMetaData* m_moduleMD;
 
     bool m_canAbortOnSpill;
+    // Start the vISA compile of each kernel on a separate thread and leave the
+    // result to VISACompileJoinPass.
+    bool m_asyncVISACompile;
 
     CEncoder::RoundingMode m_roundingMode;
     PSSignature* m_pSignature;
@@ -576,4 +581,26 @@ private:
     int getGRFSize() const { return m_currShader->getGRFSize(); }
 };
 
+/// Collects the vISA compiles that EmitPass started asynchronously for the
+/// SIMD variants of a kernel. It has to be scheduled right after the EmitPass
+/// instances, so that at most one kernel's variants are compiled at a time.
+class VISACompileJoinPass : public llvm::FunctionPass
+{
+public:
+    VISACompileJoinPass(CShaderProgram::KernelShaderMap &shaders);
+
+    virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+    {
+        AU.setPreservesAll();
+    }
+
+    virtual bool runOnFunction(llvm::Function &F) override;
+    virtual llvm::StringRef getPassName() const  override { return "VISACompileJoinPass"; }
+
+    static char ID;
+
+private:
+    CShaderProgram::KernelShaderMap &m_shaders;
+};
+
 } // namespace IGC
@@ -140,7 +140,9 @@ RegUse RegisterEstimator::estimateNumOfRegs(Value *V) const
     {
         // Flag register
         regs.rClass = (RegClass)REGISTER_CLASS_FLAG;
+        regs.nregs_simd8 = 1;
         regs.nregs_simd16 = 1;
+        regs.nregs_simd32 = 2;
         return regs;
     }
 
@@ -163,8 +165,12 @@ RegUse RegisterEstimator::estimateNumOfRegs(Value *V) const
         }
         else
         {
-            uint16_t sz16 = (nBytes * 16 + GRF_SIZE_IN_BYTE - 1) / GRF_SIZE_IN_BYTE; // SIMD16
-            regs.nregs_simd16 = sz16;
+            auto numGRFs = [nBytes](uint32_t simdsize) {
+                return (uint16_t)((nBytes * simdsize + GRF_SIZE_IN_BYTE - 1) / GRF_SIZE_IN_BYTE);
+            };
+            regs.nregs_simd8 = numGRFs(8);
+            regs.nregs_simd16 = numGRFs(16);
+            regs.nregs_simd32 = numGRFs(32);
         }
     }
     return regs;
@@ -227,11 +233,18 @@ void RegisterEstimator::calculate(bool doRPEPerInst)
 
         m_BBLiveInVirtRegs.insert(std::make_pair(BB, nCurrLiveIns));
  
-        RegUsage bbMaxRegs = nCurrLiveIns;
+        RegUsage bbMaxRegs;
+        for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
+        {
+            RegClass RC = (RegClass)i;
+            bbMaxRegs.allUses[RC].setMax(nCurrLiveIns.allUses[RC]);
+        }
 
         // Calculate the number of lives for each instruction of this BB.
-        // For simplicity, the number of lives are the one that is at exit
-        // of the instruction, not at entry (nor the largest of the both).
+        // The number saved per instruction is the one at exit of the
+        // instruction. The max of the BB is taken before the operands
+        // killed by an instruction are removed, as its destination cannot
+        // be allocated while those operands are still being read.
         for (BasicBlock::iterator I = BB->begin(), E = BB->end(); I != E; ++I)
         {
             Instruction *Inst = &*I;
@@ -245,6 +258,12 @@ void RegisterEstimator::calculate(bool doRPEPerInst)
                 }
             }
 
+            for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
+            {
+                RegClass RC = (RegClass)i;
+                bbMaxRegs.allUses[RC].setMax(nCurrLiveIns.allUses[RC]);
+            }
+
             // Kills
             ValueToValueVecMap::iterator IKill = KillInfo.find(Inst);
             if (IKill != KillInfo.end())
@@ -261,17 +280,6 @@ void RegisterEstimator::calculate(bool doRPEPerInst)
                 }
             }
 
-            for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
-            {
-                RegClass RC = (RegClass)i;
-                RegUse& ruse1 = bbMaxRegs.allUses[RC];
-                RegUse& ruse2 = nCurrLiveIns.allUses[RC];
-
-                if (ruse1 < ruse2)
-                {
-                    ruse1 = ruse2;
-                }
-            }
             if (doRPEPerInst)
             {
                 m_LiveVirtRegs.insert(std::make_pair(Inst, nCurrLiveIns));
@@ -283,12 +291,7 @@ void RegisterEstimator::calculate(bool doRPEPerInst)
 
         for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
         {
-            RegUse& ruse_max = m_MaxRegs.allUses[(RegClass)i];
-            RegUse& ruse_curr = bbMaxRegs.allUses[(RegClass)i];
-            if (ruse_max < ruse_curr)
-            {
-                ruse_max = ruse_curr;
-            }
+            m_MaxRegs.allUses[(RegClass)i].setMax(bbMaxRegs.allUses[(RegClass)i]);
         }
     }
 
@@ -39,6 +39,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "llvm/IR/Value.h"
 #include "common/LLVMWarningsPop.hpp"
 
+#include <algorithm>
+
 namespace IGC
 {
     enum RegClass : uint8_t {
@@ -59,55 +61,58 @@ namespace IGC
     };
 
     // Register Use info
+    // Non-uniform values take a number of GRFs that depends on the SIMD
+    // size. Each value is rounded up to whole GRFs on its own, as the
+    // register allocator does, so the counts are kept per SIMD size rather
+    // than derived from the SIMD16 one.
     struct RegUse
     {
         RegClass rClass;
-        //uint16_t nregs_simd8;
+        uint16_t nregs_simd8;
         uint16_t nregs_simd16;
+        uint16_t nregs_simd32;
         uint16_t uniformInBytes;
 
         RegUse() :
             rClass(REGISTER_CLASS_GRF),
-            nregs_simd16(0), uniformInBytes(0)
+            nregs_simd8(0), nregs_simd16(0), nregs_simd32(0),
+            uniformInBytes(0)
         {}
 
         RegUse(const RegUse& rhs) :
             rClass(rhs.rClass),
+            nregs_simd8(rhs.nregs_simd8),
             nregs_simd16(rhs.nregs_simd16),
+            nregs_simd32(rhs.nregs_simd32),
             uniformInBytes(rhs.uniformInBytes)
         {}
 
         RegUse& operator += (const RegUse & rhs)
         {
+            nregs_simd8 += rhs.nregs_simd8;
             nregs_simd16 += rhs.nregs_simd16;
+            nregs_simd32 += rhs.nregs_simd32;
             uniformInBytes += rhs.uniformInBytes;
             return *this;
         }
 
         RegUse& operator -= (const RegUse & rhs)
         {
-            if (nregs_simd16 > rhs.nregs_simd16)
-            {
-                nregs_simd16 -= rhs.nregs_simd16;
-            }
-            else
-            {
-                nregs_simd16 = 0;
-            }
-            if (uniformInBytes > rhs.uniformInBytes)
-            {
-                uniformInBytes -= rhs.uniformInBytes;
-            }
-            else
-            {
-                uniformInBytes = 0;
-            }
+            auto sub = [](uint16_t& lhs, uint16_t rhs) {
+                lhs = (lhs > rhs) ? lhs - rhs : 0;
+            };
+            sub(nregs_simd8, rhs.nregs_simd8);
+            sub(nregs_simd16, rhs.nregs_simd16);
+            sub(nregs_simd32, rhs.nregs_simd32);
+            sub(uniformInBytes, rhs.uniformInBytes);
             return *this;
         }
 
         RegUse& operator = (const RegUse& rhs) {
             rClass = rhs.rClass;
+            nregs_simd8 = rhs.nregs_simd8;
             nregs_simd16 = rhs.nregs_simd16;
+            nregs_simd32 = rhs.nregs_simd32;
             uniformInBytes = rhs.uniformInBytes;
             return *this;
         }
@@ -118,9 +123,24 @@ namespace IGC
             return n0 < n1;
         }
 
+        // Fold the registers live at one program point (rhs) into a running
+        // max. For each SIMD size the max is taken over the total number of
+        // GRFs at a point, uniform values included, so maxima of different
+        // points are never added together. The result keeps those totals
+        // in nregs_simd* and has no uniform bytes of its own.
+        void setMax(const RegUse& rhs) {
+            uint16_t uniformRegs = (rhs.uniformInBytes + GRF_SIZE_IN_BYTE - 1) / GRF_SIZE_IN_BYTE;
+            nregs_simd8 = std::max<uint16_t>(nregs_simd8, rhs.nregs_simd8 + uniformRegs);
+            nregs_simd16 = std::max<uint16_t>(nregs_simd16, rhs.nregs_simd16 + uniformRegs);
+            nregs_simd32 = std::max<uint16_t>(nregs_simd32, rhs.nregs_simd32 + uniformRegs);
+            uniformInBytes = 0;
+        }
+
         void clear(RegClass rc = REGISTER_CLASS_GRF) {
             rClass = rc;
+            nregs_simd8 = 0;
             nregs_simd16 = 0;
+            nregs_simd32 = 0;
             uniformInBytes = 0;
         }
     };
@@ -205,6 +225,13 @@ namespace IGC
             return isGRFPressureLow(simdsize, m_MaxRegs);
         }
 
+        // Return the max number of GRF needed at any point of the function.
+        // Only valid after calculate().
+        uint32_t getMaxLiveGRF(uint16_t simdsize = 16) const
+        {
+            return getNumRegs(m_MaxRegs.allUses[REGISTER_CLASS_GRF], simdsize);
+        }
+
         // Return true if this function has no GRF pressure at all.
         // A quick check to see if LivenessAnalysis is needed at all.
         bool hasNoGRFPressure() const { return m_noGRFPressure; }
@@ -313,9 +340,9 @@ namespace IGC
             case 16:
                 return RUse.nregs_simd16 + uniformRegs;
             case 32:
-                return 2 * RUse.nregs_simd16 + uniformRegs;
+                return RUse.nregs_simd32 + uniformRegs;
             default:
-                return (RUse.nregs_simd16 + 1)/2 + uniformRegs;
+                return RUse.nregs_simd8 + uniformRegs;
             }
         }
 
@@ -657,10 +657,10 @@ inline void AddLegalizationPasses(CodeGenContext &ctx, IGCPassManager& mpm)
     mpm.add(new WAFMinFMax());
 }
 
-inline void AddCodeGenPasses(CodeGenContext &ctx, CShaderProgram::KernelShaderMap &shaders, IGCPassManager& Passes, SIMDMode simdMode, bool canAbortOnSpill, ShaderDispatchMode shaderMode = ShaderDispatchMode::NOT_APPLICABLE, PSSignature* pSignature = nullptr)
+inline void AddCodeGenPasses(CodeGenContext &ctx, CShaderProgram::KernelShaderMap &shaders, IGCPassManager& Passes, SIMDMode simdMode, bool canAbortOnSpill, ShaderDispatchMode shaderMode = ShaderDispatchMode::NOT_APPLICABLE, PSSignature* pSignature = nullptr, bool asyncVISACompile = false)
 {
     // Generate CISA
-    Passes.add(new EmitPass(shaders, simdMode, canAbortOnSpill, shaderMode, pSignature));
+    Passes.add(new EmitPass(shaders, simdMode, canAbortOnSpill, shaderMode, pSignature, asyncVISACompile));
 }
 
 template<typename ContextType>
@@ -932,20 +932,35 @@ void CodeGen(OpenCLProgramContext *ctx, CShaderProgram::KernelShaderMap &kernels
         }
         if (ctx->getModuleMetaData()->csInfo.forcedSIMDSize)
             assert((ctx->getModuleMetaData()->csInfo.forcedSIMDSize >= leastSIMD) && "Incorrect SIMD forced");
+
+        // The SIMD variants are independent of each other here, so their vISA
+        // compiles may overlap. LLVM->vISA emission itself stays serial.
+        bool asyncVISACompile = IGC_IS_FLAG_ENABLED(EnableParallelSIMDCodeGen);
         if (leastSIMD <= 8)
         {
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD8, false);
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 16));
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32));
+            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD8, false,
+                ShaderDispatchMode::NOT_APPLICABLE, nullptr, asyncVISACompile);
+            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 16),
+                ShaderDispatchMode::NOT_APPLICABLE, nullptr, asyncVISACompile);
+            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32),
+                ShaderDispatchMode::NOT_APPLICABLE, nullptr, asyncVISACompile);
         }
         else if (leastSIMD <= 16)
         {
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, false);
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32));
+            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, false,
+                ShaderDispatchMode::NOT_APPLICABLE, nullptr, asyncVISACompile);
+            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32),
+                ShaderDispatchMode::NOT_APPLICABLE, nullptr, asyncVISACompile);
         }
         else
         {
             AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, false);
+            asyncVISACompile = false;
+        }
+
+        if (asyncVISACompile)
+        {
+            Passes.add(new VISACompileJoinPass(kernels));
         }
     }
     else
@@ -31,7 +31,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/Platform.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/Operator.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "GenISAIntrinsics/GenIntrinsics.h"
@@ -48,6 +50,7 @@ using namespace IGC::IGCMD;
 #define PASS_ANALYSIS true
 IGC_INITIALIZE_PASS_BEGIN(Simd32ProfitabilityAnalysis, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
 IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
@@ -545,11 +548,13 @@ bool Simd32ProfitabilityAnalysis::runOnFunction(Function &F)
 {
     this->F = &F; 
     CodeGenContext* context = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    LoopWeights.clear();
     if (context->type == ShaderType::OPENCL_SHADER)
     {
         PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
         LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
         WI = &getAnalysis<WIAnalysis>();
+        RPE = &getAnalysis<RegisterEstimator>();
         pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
         m_isSimd16Profitable = checkSimd16Profitable(context);
         m_isSimd32Profitable = m_isSimd16Profitable && checkSimd32Profitable(context);
@@ -557,7 +562,9 @@ bool Simd32ProfitabilityAnalysis::runOnFunction(Function &F)
     else if(context->type == ShaderType::PIXEL_SHADER)
     {
         LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
-        m_isSimd32Profitable = checkPSSimd32Profitable();
+        RPE = &getAnalysis<RegisterEstimator>();
+        m_isSimd32Profitable = checkPSSimd32Profitable() &&
+            !(IGC_IS_FLAG_ENABLED(EnableSIMDCostModel) && isLikelyToSpill(32));
     }
     return false;
 }
@@ -857,6 +864,11 @@ bool Simd32ProfitabilityAnalysis::checkSimd32Profitable(CodeGenContext *ctx)
         }
     }
 
+    if (IGC_IS_FLAG_ENABLED(EnableSIMDCostModel) &&
+        (isLikelyToSpill(32) || isSimd32ThroughputWorse())) {
+        return false;
+    }
+
     return true;
 }
 
@@ -1022,6 +1034,128 @@ static bool hasLongStridedLdStInLoop(Function *F, LoopInfo *LI, WIAnalysis *WI)
   return false;
 }
 
+/// Static SIMD cost model.
+///
+/// The SIMD variants of a kernel are compiled widest first, and a variant
+/// that spills is thrown away (or loses to a narrower one). The model below
+/// predicts that outcome from the LLVM IR, so that a width that would be
+/// discarded is not compiled at all.
+
+/// Relative execution frequency of BB, from the estimated trip counts of the
+/// loops containing it.
+unsigned Simd32ProfitabilityAnalysis::getBlockWeight(BasicBlock *BB) {
+    const unsigned MAX_WEIGHT = 1U << 16;
+    unsigned Weight = 1;
+    for (Loop *L = LI->getLoopFor(BB); L; L = L->getParentLoop()) {
+        auto I = LoopWeights.find(L);
+        if (I == LoopWeights.end()) {
+            unsigned TripWeight = 8;
+            switch (estimateLoopCount(L)) {
+            case LOOPCOUNT_LIKELY_SMALL:
+                TripWeight = 2;
+                break;
+            case LOOPCOUNT_LIKELY_LARGE:
+                TripWeight = 16;
+                break;
+            default:
+                break;
+            }
+            I = LoopWeights.insert(std::make_pair(L, TripWeight)).first;
+        }
+        Weight = std::min(Weight * I->second, MAX_WEIGHT);
+    }
+    return Weight;
+}
+
+/// Return true if the estimated GRF pressure at SIMDSize is high enough that
+/// the vISA compile is expected to spill.
+bool Simd32ProfitabilityAnalysis::isLikelyToSpill(unsigned SIMDSize) {
+    // Even with all values live, the pressure is below the SIMD16 threshold
+    // of the estimator, which is under half of what is needed to spill.
+    if (RPE->hasNoGRFPressure()) {
+        return false;
+    }
+
+    RPE->calculate();
+    const unsigned Threshold = IGC_GET_FLAG_VALUE(SIMDCostModelSpillThreshold);
+    return RPE->getMaxLiveGRF((uint16_t)SIMDSize) > Threshold;
+}
+
+/// Return true if I is lowered to a memory, sampler or URB send. Other
+/// calls that may touch memory, such as barriers and fences, are not counted.
+static bool isSendInstruction(const Instruction &I) {
+    if (isa<LoadInst>(&I) || isa<StoreInst>(&I) ||
+        isa<AtomicRMWInst>(&I) || isa<AtomicCmpXchgInst>(&I)) {
+        return true;
+    }
+    if (isa<SampleIntrinsic>(&I) || isa<SamplerLoadIntrinsic>(&I) ||
+        isa<SamplerGatherIntrinsic>(&I) || isa<InfoIntrinsic>(&I) ||
+        isa<LdRawIntrinsic>(&I) || isa<StoreRawIntrinsic>(&I) ||
+        isa<AtomicRawIntrinsic>(&I)) {
+        return true;
+    }
+    const GenIntrinsicInst *GII = dyn_cast<GenIntrinsicInst>(&I);
+    if (!GII) {
+        return false;
+    }
+    switch (GII->getIntrinsicID()) {
+    case GenISAIntrinsic::GenISA_URBRead:
+    case GenISAIntrinsic::GenISA_URBReadOutput:
+    case GenISAIntrinsic::GenISA_URBWrite:
+    case GenISAIntrinsic::GenISA_typedread:
+    case GenISAIntrinsic::GenISA_typedwrite:
+    case GenISAIntrinsic::GenISA_ldstructured:
+    case GenISAIntrinsic::GenISA_storestructured1:
+    case GenISAIntrinsic::GenISA_storestructured2:
+    case GenISAIntrinsic::GenISA_storestructured3:
+    case GenISAIntrinsic::GenISA_storestructured4:
+    case GenISAIntrinsic::GenISA_intatomictyped:
+    case GenISAIntrinsic::GenISA_icmpxchgatomictyped:
+    case GenISAIntrinsic::GenISA_dwordatomicstructured:
+    case GenISAIntrinsic::GenISA_floatatomicstructured:
+    case GenISAIntrinsic::GenISA_fcmpxchgatomicstructured:
+    case GenISAIntrinsic::GenISA_simdBlockRead:
+    case GenISAIntrinsic::GenISA_simdBlockReadBindless:
+    case GenISAIntrinsic::GenISA_simdBlockWrite:
+    case GenISAIntrinsic::GenISA_simdBlockWriteBindless:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// SIMD32 needs half the threads of SIMD16 to cover a dispatch, which mostly
+/// pays off by hiding the latency of sends. It loses when lanes sit idle
+/// under divergent control flow. Return true if, weighted by execution
+/// frequency, there is little latency to hide and most of the work is
+/// divergent.
+bool Simd32ProfitabilityAnalysis::isSimd32ThroughputWorse() {
+    // Send ratio below which SIMD32 has little latency to hide.
+    const uint64_t SEND_RATIO_DENOM = 32;
+    // Divergent ratio above which SIMD32 wastes more lanes than it hides.
+    const uint64_t DIVERGENT_RATIO_DENOM = 2;
+
+    uint64_t NumInsts = 0, NumSends = 0, NumDivergent = 0;
+    for (auto &BB : *F) {
+        unsigned Weight = getBlockWeight(&BB);
+        for (auto &I : BB) {
+            if (isa<DbgInfoIntrinsic>(&I) || isa<AllocaInst>(&I)) {
+                continue;
+            }
+            NumInsts += Weight;
+            if (WI->insideDivergentCF(&I)) {
+                NumDivergent += Weight;
+            }
+            if (isSendInstruction(I)) {
+                NumSends += Weight;
+            }
+        }
+    }
+
+    return NumSends * SEND_RATIO_DENOM < NumInsts &&
+           NumDivergent * DIVERGENT_RATIO_DENOM > NumInsts;
+}
+
 bool Simd32ProfitabilityAnalysis::checkSimd16Profitable(CodeGenContext *ctx) {
     if ((IGC_GET_FLAG_VALUE(OCLSIMD16SelectionMask) & 0x1) &&
         getLoopCyclomaticComplexity() >= CYCLOMATIC_COMPLEXITY_THRESHOLD) {
@@ -1058,6 +1192,10 @@ bool Simd32ProfitabilityAnalysis::checkSimd16Profitable(CodeGenContext *ctx) {
       return false;
     }
 
+    if (IGC_IS_FLAG_ENABLED(EnableSIMDCostModel) && isLikelyToSpill(16)) {
+      return false;
+    }
+
     return true;
 }
 
@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 
 namespace IGC
 {
@@ -60,6 +61,7 @@ namespace IGC
         {
             AU.setPreservesAll();
             AU.addRequired<WIAnalysis>();
+            AU.addRequired<RegisterEstimator>();
             AU.addRequired<llvm::LoopInfoWrapperPass>();
             AU.addRequired<llvm::PostDominatorTreeWrapperPass>();
             AU.addRequired<MetaDataUtilsWrapper>();
@@ -75,6 +77,7 @@ namespace IGC
         llvm::LoopInfo *LI;
         IGCMD::MetaDataUtils *pMdUtils;
         WIAnalysis *WI;
+        RegisterEstimator *RPE;
         bool m_isSimd32Profitable;
         bool m_isSimd16Profitable;
 
@@ -88,6 +91,12 @@ namespace IGC
 
         bool isSelectBasedOnGlobalIdX(llvm::Value *);
 
+        // Static SIMD cost model
+        unsigned getBlockWeight(llvm::BasicBlock *BB);
+        bool isLikelyToSpill(unsigned SIMDSize);
+        bool isSimd32ThroughputWorse();
+        llvm::DenseMap<llvm::Loop *, unsigned> LoopWeights;
+
         bool checkPSSimd32Profitable();
     };
 
@@ -314,7 +314,85 @@ bool WIAnalysis::runOnFunction(Function &F)
     auto *pTT = &getAnalysis<TranslationTable>();
 
     Runner.init(&F, PDT, MDUtils, CGCtx, ModMD, pTT);
-    return Runner.run();
+    Runner.setUniformSubroutineArgs(&m_uniformSubroutineArgs);
+    Runner.run();
+
+    if (MDUtils->findFunctionsInfoItem(&F) != MDUtils->end_FunctionsInfo())
+    {
+        updateUniformSubroutineArgs(F);
+    }
+    return false;
+}
+
+void WIAnalysis::updateUniformSubroutineArgs(Function &F)
+{
+    auto *MDUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+
+    SmallPtrSet<Function*, 8> Callees;
+    for (auto &I : instructions(F))
+    {
+        if (CallInst *CI = dyn_cast<CallInst>(&I))
+        {
+            Function *Callee = CI->getCalledFunction();
+            if (Callee && !Callee->isDeclaration())
+                Callees.insert(Callee);
+        }
+    }
+
+    for (Function *Callee : Callees)
+    {
+        // Arguments of stack calls and indirectly called functions follow
+        // the calling convention, which passes them as random.
+        if (Callee == &F ||
+            isEntryFunc(MDUtils, Callee) ||
+            Callee->hasFnAttribute("visaStackCall") ||
+            Callee->hasFnAttribute("IndirectlyCalled"))
+        {
+            continue;
+        }
+
+        // Only handle subroutines whose call sites are all in F. Others may
+        // have callers that are not analyzed yet.
+        bool AllCallsInF = true;
+        for (auto U : Callee->users())
+        {
+            CallInst *CI = dyn_cast<CallInst>(U);
+            if (!CI || CI->getCalledFunction() != Callee ||
+                CI->getParent()->getParent() != &F)
+            {
+                AllCallsInF = false;
+                break;
+            }
+        }
+
+        ImplicitArgs implicitArgs(*Callee, MDUtils);
+        unsigned numExplicitArgs =
+            (unsigned)(IGCLLVM::GetFuncArgSize(Callee) - implicitArgs.size());
+        for (auto &Arg : Callee->args())
+        {
+            if (Arg.getArgNo() >= numExplicitArgs)
+                break;
+
+            // Boolean arguments are kept random, as they are passed in
+            // predicate variables sized to the SIMD width.
+            bool IsUniform = AllCallsInF &&
+                IGC_IS_FLAG_DISABLED(DisableUniformSubroutineArgs) &&
+                Arg.getType()->isSingleValueType() &&
+                !Arg.getType()->getScalarType()->isIntegerTy(1);
+            for (auto U : Callee->users())
+            {
+                if (!IsUniform)
+                    break;
+                CallInst *CI = cast<CallInst>(U);
+                IsUniform = (whichDepend(CI->getArgOperand(Arg.getArgNo())) == UNIFORM);
+            }
+
+            if (IsUniform)
+                m_uniformSubroutineArgs.insert(&Arg);
+            else
+                m_uniformSubroutineArgs.erase(&Arg);
+        }
+    }
 }
 
 void WIAnalysisRunner::updateDeps()
@@ -438,8 +516,9 @@ void WIAnalysisRunner::updateArgsDependency(llvm::Function *pF)
     Assumption is that the order of metadata matches the order of arguments in function.
     */
 
-    // For a subroutine, conservatively assume that all user provided arguments
-    // are random. Note that all other functions are treated as kernels.
+    // For a subroutine, an user provided argument is random unless it has
+    // been found uniform at all call sites when analyzing the caller. Note
+    // that all other functions are treated as kernels.
     // To enable subroutine for other FEs, we need to update this check.
     bool IsSubroutine = !isEntryFunc(m_pMdUtils, pF);
 
@@ -457,7 +536,9 @@ void WIAnalysisRunner::updateArgsDependency(llvm::Function *pF)
     for (unsigned i = 0; i < implicitArgStart; ++i, ++ai)
     {
         assert(ai != ae);
-        incUpdateDepend(&(*ai), IsSubroutine ? WIAnalysis::RANDOM : WIAnalysis::UNIFORM);
+        bool IsUniform = !IsSubroutine ||
+            (m_uniformSubroutineArgs && m_uniformSubroutineArgs->count(&(*ai)));
+        incUpdateDepend(&(*ai), IsUniform ? WIAnalysis::UNIFORM : WIAnalysis::RANDOM);
     }
 
     // 2. add implicit args
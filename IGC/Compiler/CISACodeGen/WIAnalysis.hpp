@@ -111,6 +111,14 @@ public:
     WIAnalysisRunner() {}
     ~WIAnalysisRunner() {}
 
+    /// @brief Set the subroutine arguments known to be uniform at all call
+    /// sites. Other explicit arguments of subroutines are random.
+    void setUniformSubroutineArgs(
+        const llvm::DenseSet<const llvm::Argument*>* UniformArgs)
+    {
+        m_uniformSubroutineArgs = UniformArgs;
+    }
+
     bool run();
 
     /// @brief Returns the type of dependency the instruction has on
@@ -277,6 +285,9 @@ private:
     IGC::ModuleMetaData       *m_ModMD;
     IGC::TranslationTable     *m_TT;
 
+    // Optional, subroutine arguments known to be uniform
+    const llvm::DenseSet<const llvm::Argument*> *m_uniformSubroutineArgs = nullptr;
+
     // Allow access to all the store into an alloca if we were able to track it
     llvm::DenseMap<const llvm::AllocaInst*, AllocaDep> m_allocaDepMap;
     // reverse map to allow to know what alloca to update when store changes
@@ -349,12 +360,30 @@ public:
     /// check if a value is defined inside divergent control-flow
     bool insideDivergentCF(const llvm::Value* val);
 
+    /// @brief Returns True if the explicit argument 'arg' of a subroutine
+    /// is uniform at all its call sites. The subroutine's callers must have
+    /// been analyzed already.
+    bool isUniformSubroutineArg(const llvm::Argument* arg) const
+    {
+        return m_uniformSubroutineArgs.count(arg) != 0;
+    }
+
     void releaseMemory() override
     {
         Runner.releaseMemory();
     }
 private:
+    /// @brief Record the explicit arguments of the subroutines called from
+    /// F that are uniform at all call sites.
+    void updateUniformSubroutineArgs(llvm::Function& F);
+
     WIAnalysisRunner Runner;
+
+    /// Subroutine arguments that are uniform at all call sites. This is kept
+    /// across functions: callers are analyzed before their subroutines in
+    /// codegen order, and both sides need the same answer for the argument
+    /// passing to match.
+    llvm::DenseSet<const llvm::Argument*> m_uniformSubroutineArgs;
 };
 
 } // namespace IGC
@@ -0,0 +1,122 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2019 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// vim:ts=2:sw=2:et:
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+// When a kernel spills, the retry manager recompiles the program with more
+// conservative settings. Only the kernels that spilled, i.e. the ones in
+// RetryManager::kernelSet, are emitted again; the others keep the result of
+// the earlier try.
+//
+// This pass drops the bodies of the kernels that are not retried, so that the
+// remaining optimization and codegen passes only process the function groups
+// being recompiled. The kernels themselves and their metadata are kept, as
+// program-level analyses still expect to see them. Callees that were only
+// reachable from the dropped kernels become dead and are removed by a later
+// GlobalDCE.
+//
+// It has to run after ProgramScopeConstantAnalysis: the program-scope buffer
+// is laid out from the globals in use, and it has to match the layout of the
+// first try, which is the one sent to the driver.
+//
+
+namespace {
+class KernelRetryFilter : public ModulePass {
+public:
+  static char ID;
+
+  KernelRetryFilter() : ModulePass(ID) {}
+
+  bool runOnModule(Module &) override;
+
+private:
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<CodeGenContextWrapper>();
+    AU.addRequired<MetaDataUtilsWrapper>();
+  }
+};
+
+} // End anonymous namespace
+
+namespace IGC {
+
+ModulePass *createKernelRetryFilterPass() {
+  return new KernelRetryFilter();
+}
+
+#define PASS_FLAG "igc-kernel-retry-filter"
+#define PASS_DESC "Drop kernels not recompiled on retry."
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(KernelRetryFilter, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(KernelRetryFilter, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+} // End IGC namespace
+
+char KernelRetryFilter::ID = 0;
+
+bool KernelRetryFilter::runOnModule(Module &M) {
+  CodeGenContext *Ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+  MetaDataUtils *MDU = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+
+  const std::set<std::string> &KernelSet = Ctx->m_retryManager.kernelSet;
+  if (Ctx->m_retryManager.IsFirstTry() || KernelSet.empty())
+    return false;
+
+  bool Changed = false;
+  for (auto &F : M) {
+    if (F.isDeclaration() || !isEntryFunc(MDU, &F))
+      continue;
+    if (KernelSet.count(F.getName().str()))
+      continue;
+    assert(F.getReturnType()->isVoidTy() && "kernels return void");
+    // Keep a trivial body, so that the kernel is still a definition.
+    F.dropAllReferences();
+    BasicBlock *Entry = BasicBlock::Create(M.getContext(), "entry", &F);
+    ReturnInst::Create(M.getContext(), Entry);
+    Changed = true;
+  }
+
+  return Changed;
+}
@@ -563,11 +563,26 @@ TimeStats::TimeStats()
 }
 
 void TimeStats::recordVISATimers()
+{
+    recordVISATimers(readVISATimers());
+}
+
+std::vector<int64_t> TimeStats::readVISATimers()
+{
+    std::vector<int64_t> visaTimers(getTotalTimers());
+    for (unsigned int i = 0; i < visaTimers.size(); ++i)
+    {
+        visaTimers[i] = getTimerTicks(i);
+    }
+    return visaTimers;
+}
+
+void TimeStats::recordVISATimers(const std::vector<int64_t>& visaTimers)
 {
     // getTotalTimers() +1 because there is a unaccounted counter 
-    for (unsigned int i = 0; i < getTotalTimers(); ++i)
+    for (unsigned int i = 0; i < visaTimers.size(); ++i)
     {
-        m_elapsedTime[TIME_VISA_Total+i] += getTimerTicks(i);
+        m_elapsedTime[TIME_VISA_Total+i] += visaTimers[i];
     }
 }
 
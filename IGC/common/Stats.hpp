@@ -44,6 +44,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <3d/common/iStdLib/utility.h>
 
 #include <string>
+#include <vector>
 
 namespace llvm
 {
@@ -224,6 +225,12 @@ public:
     /// Capture the VISA timer values for the most recent call to VISABuilder::compile()
     void recordVISATimers();
 
+    /// The vISA timers are thread-local: a compile run on another thread reads
+    /// them with readVISATimers() on that thread and the results are recorded
+    /// here once it has been joined.
+    static std::vector<int64_t> readVISATimers();
+    void recordVISATimers(const std::vector<int64_t>& visaTimers);
+
     /// Mark that a particular timer has started timing
     void recordTimerStart( COMPILE_TIME_INTERVALS compileInterval );
     /// Mark that a particular timer has finished timing
@@ -36,6 +36,42 @@ int maxArenaLength = 0;
 int currentMallocSize = 0;
 #endif
 using namespace vISA;
+
+static _THREAD size_t arenaBytesInUse = 0;
+static _THREAD size_t peakArenaBytes = 0;
+
+size_t vISA::getArenaBytesInUse()
+{
+    return arenaBytesInUse;
+}
+
+size_t vISA::getPeakArenaBytes()
+{
+    return peakArenaBytes;
+}
+
+void vISA::resetPeakArenaBytes()
+{
+    peakArenaBytes = arenaBytesInUse;
+}
+
+void
+ArenaManager::RecordArenaAlloc(size_t size)
+{
+    arenaBytesInUse += size;
+    if (arenaBytesInUse > peakArenaBytes)
+    {
+        peakArenaBytes = arenaBytesInUse;
+    }
+}
+
+void
+ArenaManager::RecordArenaFree(size_t size)
+{
+    // an arena may be released by a different thread than the one that created it
+    arenaBytesInUse = size < arenaBytesInUse ? arenaBytesInUse - size : 0;
+}
+
 void*
 ArenaHeader::AllocSpace (size_t size)
 {
@@ -70,6 +106,7 @@ ArenaManager::FreeArenas()
 #ifdef COLLECT_ALLOCATION_STATS
         currentMallocSize -= _arenas->size;
 #endif
+        RecordArenaFree(_arenas->size);
         unsigned char* killed = (unsigned char*) _arenas;
         _arenas = _arenas->_nextArena;
         delete [] killed;
@@ -51,6 +51,14 @@ extern int currentMallocSize;
 
 namespace vISA
 {
+    // Bytes currently held by the arenas of the calling thread, and the
+    // high-water mark of that value (used by the compile-time statistics).
+    // The high-water mark is per thread and lives across builders, so it is
+    // reset to the current usage whenever a compile starts on a thread.
+    size_t getArenaBytesInUse();
+    size_t getPeakArenaBytes();
+    void resetPeakArenaBytes();
+
     class Mem_Manager;
     class ArenaHeader
     {
@@ -177,6 +185,7 @@ namespace vISA
 
             //std::cout << "Create new Buffer: " << (arenaDataSize / 1024) << " KB" << std::endl;
             _arenas = newArena;
+            RecordArenaAlloc(arenaDataSize);
 
 #ifdef COLLECT_ALLOCATION_STATS
             numMallocCalls++;
@@ -201,6 +210,8 @@ namespace vISA
         }
 
         void FreeArenas();
+        static void RecordArenaAlloc(size_t size);
+        static void RecordArenaFree(size_t size);
 
         // Data
 
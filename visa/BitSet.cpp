@@ -156,6 +156,61 @@ void vector_minus(T *__restrict__ p1, const T *const p2, unsigned n)
     }
 }
 
+// The change-reporting kernels accumulate the xor of old and new words instead
+// of comparing word by word, so the loop has no early exit and stays
+// vectorizable; the caller learns about changes without a second pass.
+template <typename T>
+T vector_or_diff(T *__restrict__ p1, const T *const p2, unsigned n)
+{
+    T diff = 0;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        T v = p1[i] | p2[i];
+        diff |= v ^ p1[i];
+        p1[i] = v;
+    }
+    return diff;
+}
+
+template <typename T>
+T vector_gen_kill_diff(T *__restrict__ p1, const T *const gen,
+    const T *const in, const T *const kill, unsigned n)
+{
+    T diff = 0;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        T v = gen[i] | (in[i] & ~kill[i]);
+        diff |= v ^ p1[i];
+        p1[i] = v;
+    }
+    return diff;
+}
+
+bool BitSet::orWithChange(const BitSet& other)
+{
+    unsigned size = other.m_Size;
+
+    //grow the set to the size of the other set if necessary
+    if (m_Size < other.m_Size)
+    {
+        create(other.m_Size);
+        size = m_Size;
+    }
+
+    unsigned arraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    return vector_or_diff(m_BitSetArray, other.m_BitSetArray, arraySize) != 0;
+}
+
+bool BitSet::assignGenKill(const BitSet& gen, const BitSet& in, const BitSet& kill)
+{
+    MUST_BE_TRUE(gen.m_Size == m_Size && in.m_Size == m_Size && kill.m_Size == m_Size,
+        "BitSet operands must have the same size");
+
+    unsigned arraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    return vector_gen_kill_diff(m_BitSetArray, gen.m_BitSetArray, in.m_BitSetArray,
+        kill.m_BitSetArray, arraySize) != 0;
+}
+
 BitSet& BitSet::operator|=( const BitSet& other )
 {
     unsigned size = other.m_Size;
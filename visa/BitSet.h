@@ -28,8 +28,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define _BITSET_H_
 
 #include "Mem_Manager.h"
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 // Array-based bitset implementation where each element occupies a single bit.
 // Inside each array element, bits are stored and indexed from lsb to msb.
@@ -346,6 +348,12 @@ public:
     BitSet &operator&=(const BitSet &other);
     BitSet &operator-=(const BitSet &other);
 
+    // this |= other; returns true if any bit of this set changed.
+    bool orWithChange(const BitSet &other);
+    // this = gen | (in - kill); returns true if the result differs from the
+    // previous contents. All three operands must be the same size as this set.
+    bool assignGenKill(const BitSet &gen, const BitSet &in, const BitSet &kill);
+
     void *operator new(size_t sz, vISA::
         Mem_Manager &m) { return m.alloc(sz); }
 
@@ -372,4 +380,107 @@ protected:
     }
 };
 
+// Sparse bitset for index spaces too large for a dense BitSet per element.
+// Bits are grouped into fixed-size chunks of CHUNK_WORDS array elements and
+// only chunks with at least one bit set are allocated. Chunks are kept sorted
+// by index, so lookups are a binary search over a contiguous array and
+// iteration is in increasing bit order. setElt() ORs in a whole element at a
+// time, so callers holding a dense BitSet can merge it word by word.
+class SparseBitSet
+{
+public:
+    static const unsigned CHUNK_WORDS = 8;
+    static const unsigned CHUNK_BITS = CHUNK_WORDS * NUM_BITS_PER_ELT;
+
+    bool isSet(unsigned index) const
+    {
+        const Chunk* chunk = findChunk(index / CHUNK_BITS);
+        if (chunk == nullptr)
+        {
+            return false;
+        }
+        unsigned bitInChunk = index % CHUNK_BITS;
+        return (chunk->words[bitInChunk / NUM_BITS_PER_ELT] & BIT(bitInChunk % NUM_BITS_PER_ELT)) != 0;
+    }
+
+    void set(unsigned index)
+    {
+        setElt(index / NUM_BITS_PER_ELT, BIT(index % NUM_BITS_PER_ELT));
+    }
+
+    // OR value into the array element eltIndex.
+    void setElt(unsigned eltIndex, BITSET_ARRAY_TYPE value)
+    {
+        Chunk& chunk = getOrCreateChunk(eltIndex / CHUNK_WORDS);
+        chunk.words[eltIndex % CHUNK_WORDS] |= value;
+    }
+
+    void clear()
+    {
+        m_Chunks.clear();
+        m_LastChunk = 0;
+    }
+
+    bool isEmpty() const { return m_Chunks.empty(); }
+
+    // Invoke func on the index of every set bit, in increasing order.
+    template <typename Func>
+    void forEach(Func func) const
+    {
+        for (const Chunk& chunk : m_Chunks)
+        {
+            for (unsigned w = 0; w < CHUNK_WORDS; w++)
+            {
+                BITSET_ARRAY_TYPE elt = chunk.words[w];
+                unsigned base = chunk.index * CHUNK_BITS + w * NUM_BITS_PER_ELT;
+                for (unsigned bit = 0; elt != 0; bit++, elt >>= 1)
+                {
+                    if (elt & 1)
+                    {
+                        func(base + bit);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    struct Chunk
+    {
+        unsigned index;
+        BITSET_ARRAY_TYPE words[CHUNK_WORDS];
+    };
+
+    std::vector<Chunk> m_Chunks;
+    // Position of the most recently updated chunk. Updates tend to walk a
+    // dense bitset in order, so most of them hit the same chunk again.
+    unsigned m_LastChunk = 0;
+
+    static bool chunkBefore(const Chunk& chunk, unsigned index) { return chunk.index < index; }
+
+    const Chunk* findChunk(unsigned chunkIndex) const
+    {
+        auto it = std::lower_bound(m_Chunks.begin(), m_Chunks.end(), chunkIndex, chunkBefore);
+        return (it != m_Chunks.end() && it->index == chunkIndex) ? &*it : nullptr;
+    }
+
+    Chunk& getOrCreateChunk(unsigned chunkIndex)
+    {
+        if (m_LastChunk < m_Chunks.size() && m_Chunks[m_LastChunk].index == chunkIndex)
+        {
+            return m_Chunks[m_LastChunk];
+        }
+        auto it = std::lower_bound(m_Chunks.begin(), m_Chunks.end(), chunkIndex, chunkBefore);
+        if (it == m_Chunks.end() || it->index != chunkIndex)
+        {
+            Chunk chunk;
+            chunk.index = chunkIndex;
+            std::memset(chunk.words, 0, sizeof(chunk.words));
+            it = m_Chunks.insert(it, chunk);
+        }
+        m_LastChunk = (unsigned)(it - m_Chunks.begin());
+        return *it;
+    }
+};
+
 #endif
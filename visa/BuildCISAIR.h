@@ -43,6 +43,11 @@ extern int CISAdebug;
 #include "VISABuilderAPIDefinition.h"
 #include "visa_wa.h"
 
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
 class Options;
 
 class CISA_IR_Builder : public VISABuilder
@@ -65,6 +70,7 @@ public:
         m_cisaBinary = new (m_mem) CisaFramework::CisaBinary(&m_options);
         m_currentKernel = NULL;
         m_pWaTable = pWaTable;
+        m_creatorThread = std::this_thread::get_id();
     }
 
     virtual ~CISA_IR_Builder();
@@ -109,6 +115,7 @@ public:
 
     // Used for inline asm code generation
     CM_BUILDER_API virtual int ParseVISAText(const std::string& visaHeader, const std::string& visaText, const std::string& visaTextFile);
+    CM_BUILDER_API virtual int ParseInlineVISAText(VISAKernel* kernel, const std::string& visaText);
     CM_BUILDER_API virtual int WriteVISAHeader();
     CM_BUILDER_API std::stringstream& GetAsmTextStream() { return m_ssIsaAsm; }
     CM_BUILDER_API std::stringstream& GetAsmTextHeaderStream() { return m_ssIsaAsmHeader; }
@@ -733,6 +740,13 @@ public:
 
 private:
 
+    void initThreadLocalState();
+    unsigned getNumCompileThreads() const;
+    int compileUnitsInParallel(
+        const std::vector<VISAKernelImpl*>& units,
+        unsigned numThreads,
+        const std::function<int(VISAKernelImpl*)>& compileFn);
+
     vISA::Mem_Manager m_mem;
     CM_VISA_BUILDER_OPTION mBuildOption;
     bool m_executionSatarted;
@@ -754,6 +768,20 @@ private:
     PVISA_WA_TABLE m_pWaTable;
 
     void* gtpin_init = nullptr;
+
+    // vISA keeps the platform, stepping, timers and the active builder in
+    // thread-local globals; these let Compile() re-establish them when it is
+    // called on a different thread than the one that created the builder.
+    std::thread::id m_creatorThread;
+    TARGET_PLATFORM m_platform = GENX_NONE;
+    const char* m_stepping = nullptr;
+
+    // Arena usage of the compiling thread when this builder took it over, and
+    // the sum of the arena peaks reached by the worker threads of
+    // compileUnitsInParallel; together they give the builder's peak arena
+    // footprint for the compile-time statistics.
+    size_t m_arenaBaseBytes = 0;
+    std::atomic<size_t> m_workerPeakArenaBytes{0};
 };
 extern _THREAD CISA_IR_Builder * pCisaBuilder;
 
@@ -29,6 +29,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include <fstream>
 #include <list>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
 
 #include "visa_igc_common_header.h"
 #include "Common_ISA.h"
@@ -289,7 +293,10 @@ int CISA_IR_Builder::CreateBuilder(
     // initialize stepping to none in case it's not passed in
     InitStepping();
 
+    resetPeakArenaBytes();
+    size_t arenaBaseBytes = getArenaBytesInUse();
     builder = new CISA_IR_Builder(buildOption, COMMON_ISA_MAJOR_VER, COMMON_ISA_MINOR_VER, pWaTable);
+    builder->m_arenaBaseBytes = arenaBaseBytes;
     pCisaBuilder = builder;
 
     if (!builder->m_options.parseOptions(numArgs, flags))
@@ -330,6 +337,10 @@ int CISA_IR_Builder::CreateBuilder(
         builder->m_options.setOptionInternally(vISA_EmitLocation, true);
     }
 
+    // options may override the platform and stepping
+    builder->m_platform = getGenxPlatform();
+    builder->m_stepping = GetSteppingString();
+
     // we must wait till after the options are processed,
     // so that stepping is set and init will work properly
     if (initWA)
@@ -693,10 +704,150 @@ int CISA_IR_Builder::ParseVISAText(const std::string& visaHeader, const std::str
 #endif
 }
 
+// Parse the inline asm in VISATEXT straight into KERNEL. Unlike
+// ParseVISAText(), the rest of the kernel is built through the API and is
+// never written out as text.
+int CISA_IR_Builder::ParseInlineVISAText(VISAKernel* kernel, const std::string& visaText)
+{
+#if defined(__linux__) || defined(_WIN64) || defined(_WIN32)
+#if defined(_WIN64) || defined(_WIN32)
+    CISAout = fopen("nul", "w");
+#else
+    CISAout = fopen("/dev/null", "w");
+#endif
+
+    VISAKernelImpl *savedKernel = m_kernel;
+    CISA_IR_Builder *savedBuilder = pCisaBuilder;
+    bool savedParseMode = m_options.getOption(vISA_isParseMode);
+
+    m_kernel = static_cast<VISAKernelImpl *>(kernel);
+    pCisaBuilder = this;
+    // Variables declared by the snippet are named like in a parsed kernel.
+    m_options.setOptionInternally(vISA_isParseMode, true);
+    m_kernel->setResolveDefaultNames(true);
+
+    YY_BUFFER_STATE visaBuf = CISA_scan_string(visaText.c_str());
+    int status = CISAparse() == 0 ? CM_SUCCESS : CM_FAILURE;
+    CISA_delete_buffer(visaBuf);
+
+    m_kernel->setResolveDefaultNames(false);
+    m_options.setOptionInternally(vISA_isParseMode, savedParseMode);
+    pCisaBuilder = savedBuilder;
+    m_kernel = savedKernel;
+
+    if (CISAout)
+    {
+        fclose(CISAout);
+        CISAout = NULL;
+    }
+
+    assert(status == CM_SUCCESS && "Parsing inline visa text failed");
+    return status;
+#else
+    assert(0 && "Asm parsing not supported on this platform");
+    return CM_FAILURE;
+#endif
+}
+
+// Set up the thread-local vISA globals for compiling with this builder on the
+// calling thread. Timers and the arena peak restart, so phases run on this
+// thread are not reflected in the creating thread's timer dump.
+void CISA_IR_Builder::initThreadLocalState()
+{
+    initTimer();
+    resetPeakArenaBytes();
+    SetVisaPlatform(m_platform);
+    InitStepping();
+    SetStepping(m_stepping);
+    pCisaBuilder = this;
+}
+
+// Number of worker threads to use for compiling the units of this program.
+// 0 means one thread per hardware core; 1 (the default) means serial compilation.
+unsigned CISA_IR_Builder::getNumCompileThreads() const
+{
+    unsigned numThreads = m_options.getuInt32Option(vISA_NumCompileThreads);
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (m_options.getOption(vISA_UniqueLabels))
+    {
+        // label emission depends on the builder's current kernel
+        numThreads = 1;
+    }
+    return numThreads;
+}
+
+// Run compileFn on every unit on up to numThreads worker threads.
+// Each VISAKernelImpl owns its Mem_Manager and IR_Builder, so units do not share
+// IR; only the per-thread vISA globals (platform, stepping, timers, current builder)
+// have to be replicated on each worker.
+// The status of the first failing unit in list order is returned, so the result does
+// not depend on the order in which the workers finish.
+int CISA_IR_Builder::compileUnitsInParallel(
+    const std::vector<VISAKernelImpl*>& units,
+    unsigned numThreads,
+    const std::function<int(VISAKernelImpl*)>& compileFn)
+{
+    std::vector<int> unitStatus(units.size(), CM_SUCCESS);
+    std::atomic<size_t> nextUnit(0);
+
+    auto worker = [&]()
+    {
+        initThreadLocalState();
+        size_t arenaBaseBytes = getArenaBytesInUse();
+        for (size_t i = nextUnit++; i < units.size(); i = nextUnit++)
+        {
+            unitStatus[i] = compileFn(units[i]);
+        }
+        // the workers' peaks need not coincide, so their sum is an upper bound
+        m_workerPeakArenaBytes += getPeakArenaBytes() - arenaBaseBytes;
+    };
+
+    numThreads = std::min(numThreads, (unsigned) units.size());
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < numThreads; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    // the calling thread already has the vISA globals set up, so it doesn't
+    // need the worker prologue
+    for (size_t i = nextUnit++; i < units.size(); i = nextUnit++)
+    {
+        unitStatus[i] = compileFn(units[i]);
+    }
+    for (auto& t : workers)
+    {
+        t.join();
+    }
+
+    for (int status : unitStatus)
+    {
+        if (status != CM_SUCCESS)
+        {
+            return status;
+        }
+    }
+    return CM_SUCCESS;
+}
+
 // default size of the kernel mem manager in bytes
 #define KERNEL_MEM_SIZE    (4*1024*1024)
 int CISA_IR_Builder::Compile( const char* nameInput)
 {
+    if (std::this_thread::get_id() != m_creatorThread)
+    {
+        initThreadLocalState();
+        m_arenaBaseBytes = getArenaBytesInUse();
+        startTimer(TIMER_TOTAL);
+        startTimer(TIMER_BUILDER);
+    }
+    else
+    {
+        // another builder may have been created on this thread since
+        pCisaBuilder = this;
+    }
 
     stopTimer(TIMER_BUILDER);   // TIMER_BUILDER is started when builder is created
     int status = CM_SUCCESS;
@@ -780,6 +931,8 @@ int CISA_IR_Builder::Compile( const char* nameInput)
 
         pseudoHeader.functions = (function_info_t*)mem.alloc(sizeof(function_info_t) * pseudoHeader.num_functions);
 
+        unsigned numThreads = getNumCompileThreads();
+
         int i;
         unsigned int k = 0;
         std::list<VISAKernelImpl*> kernels;
@@ -814,6 +967,12 @@ int CISA_IR_Builder::Compile( const char* nameInput)
                 kernels.push_back(kernel);
             }
 
+            if (numThreads > 1)
+            {
+                // compiled below once all units are set up
+                continue;
+            }
+
             m_currentKernel = kernel;
 
             int status =  kernel->compileFastPath();
@@ -824,6 +983,18 @@ int CISA_IR_Builder::Compile( const char* nameInput)
             }
         }
 
+        if (numThreads > 1)
+        {
+            std::vector<VISAKernelImpl*> units(m_kernels.begin(), m_kernels.end());
+            int status = compileUnitsInParallel(units, numThreads,
+                [](VISAKernelImpl* unit) { return unit->compileFastPath(); });
+            if (status != CM_SUCCESS)
+            {
+                stopTimer(TIMER_TOTAL);
+                return status;
+            }
+        }
+
         savedFCallStates savedFCallState;
 
         for(std::list<VISAKernelImpl*>::iterator kernel_it = kernels.begin(), kend = kernels.end();
@@ -857,26 +1028,56 @@ int CISA_IR_Builder::Compile( const char* nameInput)
             }
         }
 
-        for (auto kernel_it = kernels.begin(); kernel_it != kernels.end(); kernel_it++ )
+        if (numThreads > 1 && functions.empty())
         {
-            VISAKernelImpl* kernel = (*kernel_it);
-            m_currentKernel = kernel;
-
-            unsigned int genxBufferSize = 0;
-
-            Stitch_Compiled_Units(kernel->getKernel(), allFunctions);
+            // Without stack-call functions nothing is stitched into the kernels
+            // (stitching only lowers their fcall/fret), so their back ends are
+            // independent of each other as well.
+            // Binaries are attached to each kernel, so the output order is unchanged.
+            std::vector<VISAKernelImpl*> units(kernels.begin(), kernels.end());
+            int status = compileUnitsInParallel(units, numThreads,
+                [this, &allFunctions](VISAKernelImpl* kernel)
+                {
+                    unsigned int genxBufferSize = 0;
 
-            void* genxBuffer = kernel->compilePostOptimize(genxBufferSize);
-            kernel->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
+                    Stitch_Compiled_Units(kernel->getKernel(), allFunctions);
 
-            if(m_options.getOption(vISA_GenerateDebugInfo))
+                    void* genxBuffer = kernel->compilePostOptimize(genxBufferSize);
+                    kernel->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
+                    if (m_options.getOption(vISA_GenerateDebugInfo))
+                    {
+                        std::list<VISAKernelImpl*> noFunctions;
+                        kernel->computeAndEmitDebugInfo(noFunctions);
+                    }
+                    return CM_SUCCESS;
+                });
+            if (status != CM_SUCCESS)
             {
-                kernel->computeAndEmitDebugInfo(functions);
+                stopTimer(TIMER_TOTAL);
+                return status;
             }
+        }
+        else
+        {
+            for (auto kernel_it = kernels.begin(); kernel_it != kernels.end(); kernel_it++ )
+            {
+                VISAKernelImpl* kernel = (*kernel_it);
+                m_currentKernel = kernel;
 
-            restoreFCallState( kernel->getKernel(), savedFCallState );
+                unsigned int genxBufferSize = 0;
+
+                Stitch_Compiled_Units(kernel->getKernel(), allFunctions);
 
+                void* genxBuffer = kernel->compilePostOptimize(genxBufferSize);
+                kernel->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
 
+                if(m_options.getOption(vISA_GenerateDebugInfo))
+                {
+                    kernel->computeAndEmitDebugInfo(functions);
+                }
+
+                restoreFCallState( kernel->getKernel(), savedFCallState );
+            }
         }
 
 
@@ -925,6 +1126,21 @@ int CISA_IR_Builder::Compile( const char* nameInput)
         m_options.getOption(VISA_AsmFileName, asmName);
         dumpAllTimers(asmName, true);
     }
+    if (m_options.getOptionCstr(vISA_dumpTimerJSON))
+    {
+        const char *jsonName = nullptr;
+        const char *asmName = nullptr;
+        m_options.getOption(vISA_dumpTimerJSON, jsonName);
+        m_options.getOption(VISA_AsmFileName, asmName);
+
+        unsigned binarySize = 0;
+        for (auto kernel : m_kernels)
+        {
+            binarySize += (unsigned)kernel->getGenxBinarySize();
+        }
+        size_t peakArenaBytes = getPeakArenaBytes() - m_arenaBaseBytes + m_workerPeakArenaBytes;
+        dumpAllTimersJSON(jsonName, asmName, binarySize, peakArenaBytes);
+    }
 
     return status;
 }
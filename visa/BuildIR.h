@@ -531,6 +531,8 @@ public:
     unsigned            num_temp_dcl;
     // number of temp GRF vars created to hold spilled addr/flag
     uint32_t            numAddrFlagSpillLoc = 0;
+    // number of temp dsts created when splitting sampler messages
+    unsigned            numTmpSmplDst = 0;
     std::vector<input_info_t*> m_inputVect;
 
     const Options* getOptions() const { return m_options; }
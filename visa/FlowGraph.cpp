@@ -251,7 +251,7 @@ G4_BB* FlowGraph::createNewBB(bool insertInFG)
     return bb;
 }
 
-static int globalCount = 1;
+static _THREAD int globalCount = 1;
 int64_t FlowGraph::insertDummyUUIDMov()
 {
     // Here when -addKernelId is passed
@@ -3566,6 +3566,10 @@ void G4_Kernel::emit_asm(std::ostream& output, bool beforeRegAlloc, void * binar
             if (jitInfo->spillMemUsed > 0)
             {
                 output << "\n" << "//.spill size " << jitInfo->spillMemUsed;
+                if (jitInfo->spillMemUnshared > jitInfo->spillMemUsed)
+                {
+                    output << "\n" << "//.spill size without slot sharing " << jitInfo->spillMemUnshared;
+                }
             }
             if (jitInfo->numGRFSpillFill > 0)
             {
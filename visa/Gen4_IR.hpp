@@ -138,6 +138,125 @@ namespace vISA
 
         bool operator!=(const std_arena_based_allocator & a) const { return !operator==(a); }
     };
+
+    //
+    // Arena based allocator for node based containers with heavy insert/erase
+    // churn (the instruction lists). Single node deallocations go to a free list
+    // and are handed out again by the next allocation of the same size, so erased
+    // nodes are reused while they are still cache-warm instead of growing the
+    // arena for the rest of the compilation. The free-list link is kept in the
+    // last pointer-sized word of the node (the payload of a std::list node), so
+    // the container's own links in a freed node are left untouched until reuse.
+    //
+    struct RecyclingArena
+    {
+        Mem_Manager mem;
+        void* freeNodes;    // singly linked list of recycled nodes
+        size_t nodeSize;    // size of the nodes on freeNodes
+        RecyclingArena() : mem(4096), freeNodes(nullptr), nodeSize(0) {}
+    };
+
+    template <class T>
+    class std_arena_recycling_allocator
+    {
+    protected:
+        std::shared_ptr<RecyclingArena> arena_ptr;
+
+        static void*& nextFree(void* node, size_t size)
+        {
+            return *(void**)((char*)node + (size / sizeof(void*) - 1) * sizeof(void*));
+        }
+
+    public:
+
+        //for allocator_traits
+        typedef std::size_t    size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T*             pointer;
+        typedef const T*       const_pointer;
+        typedef T&             reference;
+        typedef const T&       const_reference;
+        typedef T              value_type;
+
+        explicit std_arena_recycling_allocator()
+            : arena_ptr(std::make_shared<RecyclingArena>())
+        {
+        }
+
+        std_arena_recycling_allocator(const std_arena_recycling_allocator& other)
+            : arena_ptr(other.arena_ptr)
+        {}
+
+        template <class U>
+        std_arena_recycling_allocator(const std_arena_recycling_allocator<U>& other)
+            : arena_ptr(other.arena_ptr)
+        {}
+
+        template <class U>
+        std_arena_recycling_allocator& operator=(const std_arena_recycling_allocator<U>& other)
+        {
+            arena_ptr = other.arena_ptr;
+            return *this;
+        }
+
+        template <class U>
+        struct rebind { typedef std_arena_recycling_allocator<U> other; };
+
+        template <class U> friend class std_arena_recycling_allocator;
+
+        pointer allocate(size_type n, const void * = 0)
+        {
+            size_t size = n * sizeof(T);
+            RecyclingArena& arena = *arena_ptr;
+            if (size == arena.nodeSize && arena.freeNodes)
+            {
+                void* node = arena.freeNodes;
+                arena.freeNodes = nextFree(node, size);
+                return (T*)node;
+            }
+            return (T*)arena.mem.alloc(size);
+        }
+
+        void deallocate(void* p, size_type n)
+        {
+            // only single nodes are recycled; the arena frees everything else at once
+            size_t size = n * sizeof(T);
+            RecyclingArena& arena = *arena_ptr;
+            if (n != 1 || size < sizeof(void*))
+            {
+                return;
+            }
+            if (arena.nodeSize == 0)
+            {
+                arena.nodeSize = size;
+            }
+            if (size == arena.nodeSize)
+            {
+                nextFree(p, size) = arena.freeNodes;
+                arena.freeNodes = p;
+            }
+        }
+
+        pointer           address(reference x) const { return &x; }
+        const_pointer     address(const_reference x) const { return &x; }
+
+        std_arena_recycling_allocator<T>&  operator=(const std_arena_recycling_allocator&)
+        {
+            return *this;
+        }
+
+        void              construct(pointer p, const T& val)
+        {
+            new ((T*)p) T(val);
+        }
+        void              destroy(pointer p) { p->~T(); }
+
+        size_type         max_size() const { return size_t(-1); }
+
+        bool operator==(const std_arena_recycling_allocator &) const { return true; }
+
+        bool operator!=(const std_arena_recycling_allocator & a) const { return !operator==(a); }
+    };
 }
 void resetRightBound(vISA::G4_Operand* opnd);
 
@@ -210,7 +329,7 @@ typedef enum
 } G4_MathOp;
 
 
-typedef vISA::std_arena_based_allocator<vISA::G4_INST*> INST_LIST_NODE_ALLOCATOR;
+typedef vISA::std_arena_recycling_allocator<vISA::G4_INST*> INST_LIST_NODE_ALLOCATOR;
 
 typedef std::list<vISA::G4_INST*, INST_LIST_NODE_ALLOCATOR>           INST_LIST;
 typedef std::list<vISA::G4_INST*, INST_LIST_NODE_ALLOCATOR>::iterator INST_LIST_ITER;
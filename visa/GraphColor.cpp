@@ -47,6 +47,8 @@ using namespace std;
 using namespace vISA;
 
 #define FAIL_SAFE_RA_LIMIT 3
+// Number of RA iterations that may try remat before spilling
+#define MAX_REMAT_RUNS 2
 
 #define MIN(x,y)    (((x)<(y))? (x):(y))
 #define MAX(x,y)    (((x)<(y))? (y):(x))
@@ -1357,8 +1359,7 @@ bool Interference::interfereBetween(unsigned v1, unsigned v2) const
     }
     else
     {
-        auto&& set = sparseMatrix[v1];
-        return set.find(v2) != set.end();
+        return sparseMatrix[v1].isSet(v2);
     }
 }
 
@@ -2172,12 +2173,14 @@ void Interference::generateSparseIntfGraph()
     {
         for (uint32_t v1 = 0; v1 < maxId; ++v1)
         {
-            auto&& intfSet = sparseMatrix[v1];
-            for (uint32_t v2 : intfSet)
+            sparseMatrix[v1].forEach([&](uint32_t v2)
             {
-                sparseIntf[v1].push_back(v2);
-                sparseIntf[v2].push_back(v1);
-            }
+                if (v2 != v1)
+                {
+                    sparseIntf[v1].push_back(v2);
+                    sparseIntf[v2].push_back(v1);
+                }
+            });
         }
     }
 
@@ -8728,6 +8731,7 @@ int GlobalRA::coloringRegAlloc()
     bool enableSpillSpaceCompression = builder.getOption(vISA_SpillSpaceCompression);
 
     uint32_t nextSpillOffset = 0;
+    uint32_t unsharedSpillSize = 0;
     uint32_t scratchOffset = 0;
 
     uint32_t GRFSpillFillCount = 0;
@@ -8735,8 +8739,13 @@ int GlobalRA::coloringRegAlloc()
     uint32_t sendAssociatedGRFSpillFillCount = 0;
     unsigned failSafeRAIteration = builder.getOption(vISA_FastSpill) ? 1 : FAIL_SAFE_RA_LIMIT;
 
-    bool rematDone = false;
+    unsigned int rematRuns = 0;
+    unsigned int maxRematRuns = builder.getOption(vISA_FastSpill) ? 1 : MAX_REMAT_RUNS;
+    unsigned int lastRematIteration = 0;
     VarSplit splitPass(*this);
+    // liveness of the previous iteration, set only when that iteration
+    // ended by inserting spill code
+    LivenessSeed livenessSeed;
     while (iterationNo < maxRAIterations)
     {
         if (builder.getOption(vISA_RATrace))
@@ -8803,7 +8812,22 @@ int GlobalRA::coloringRegAlloc()
         }
 
         LivenessAnalysis liveAnalysis(*this, G4_GRF | G4_INPUT);
-        liveAnalysis.computeLiveness();
+        liveAnalysis.computeLiveness(&livenessSeed);
+#ifdef _DEBUG
+        bool verifySeed = !livenessSeed.empty();
+#else
+        bool verifySeed = !livenessSeed.empty() &&
+            builder.getOption(vISA_VerifyIncrementalRALiveness);
+#endif
+        if (verifySeed)
+        {
+            // the seeded solution must be the same as a full recompute
+            LivenessAnalysis fullLiveAnalysis(*this, G4_GRF | G4_INPUT);
+            fullLiveAnalysis.computeLiveness();
+            MUST_BE_TRUE(liveAnalysis.hasSameSolution(fullLiveAnalysis),
+                "seeded liveness differs from a full recompute");
+        }
+        livenessSeed.clear();
         if (builder.getOption(vISA_dumpLiveness))
         {
             liveAnalysis.dump();
@@ -8823,7 +8847,7 @@ int GlobalRA::coloringRegAlloc()
             rpe.run();
             GraphColor coloring(liveAnalysis, kernel.getNumRegTotal(), false, forceSpill);
 
-            if (builder.getOption(vISA_dumpRPE) && iterationNo == 0 && !rematDone)
+            if (builder.getOption(vISA_dumpRPE) && iterationNo == 0 && rematRuns == 0)
             {
                 // dump pressure the first time we enter global RA
                 coloring.dumpRegisterPressure();
@@ -8849,7 +8873,10 @@ int GlobalRA::coloringRegAlloc()
                 bool rematChange = false;
                 bool globalSplitChange = false;
 
-                if (!rematDone &&
+                // Remat is retried once spill code has been inserted as the
+                // new set of spilled ranges may have other cheap defs to remat.
+                if (rematRuns < maxRematRuns &&
+                    (rematRuns == 0 || iterationNo != lastRematIteration) &&
                     rematOff)
                 {
                     if (builder.getOption(vISA_RATrace))
@@ -8858,7 +8885,8 @@ int GlobalRA::coloringRegAlloc()
                     }
                     Rematerialization remat(kernel, liveAnalysis, coloring, rpe, *this);
                     remat.run();
-                    rematDone = true;
+                    rematRuns++;
+                    lastRematIteration = iterationNo;
 
                     // Re-run GRA loop only if remat caused changes to IR
                     if (remat.getChangesMade())
@@ -8897,8 +8925,10 @@ int GlobalRA::coloringRegAlloc()
                     globalSplitChange = true;
                 }
 
-                if (iterationNo == 0 &&
-                    (rematChange || globalSplitChange))
+                // Spill decisions above were made on the IR before remat, so
+                // color again whenever remat changed it.
+                if (rematChange ||
+                    (iterationNo == 0 && globalSplitChange))
                 {
                     continue;
                 }
@@ -8957,6 +8987,12 @@ int GlobalRA::coloringRegAlloc()
                     }
                 }
 
+                // the seed has to be taken before spill code changes the IR
+                if (builder.getOption(vISA_IncrementalRALiveness) && !reserveSpillReg)
+                {
+                    liveAnalysis.saveSeed(livenessSeed);
+                }
+
                 startTimer(TIMER_SPILL);
                 SpillManagerGMRF spillGMRF(*this,
                     nextSpillOffset,
@@ -8973,12 +9009,17 @@ int GlobalRA::coloringRegAlloc()
                     useScratchMsgForSpill);
 
                 bool success = spillGMRF.insertSpillFillCode(&kernel, pointsToAnalysis);
+                // without slot sharing this iteration's ranges are placed after
+                // everything the previous iterations used, shared or not
+                unsharedSpillSize = std::max(unsharedSpillSize, nextSpillOffset) +
+                    spillGMRF.getUnsharedSpillSize();
                 nextSpillOffset = spillGMRF.getNextOffset();
 
                 if (builder.getOption(vISA_RATrace))
                 {
                     std::cout << "\t--# variables spilled: " << coloring.getSpilledLiveRanges().size() << "\n";
-                    std::cout << "\t--current spill size: " << nextSpillOffset << "\n";
+                    std::cout << "\t--current spill size: " << nextSpillOffset <<
+                        " (" << unsharedSpillSize << " without slot sharing)\n";
                 }
 
                 if (!success)
@@ -9127,6 +9168,7 @@ int GlobalRA::coloringRegAlloc()
         spillMemUsed = std::max(spillMemUsed, scratchSize);
         jitInfo->isSpill = spillMemUsed > 0;
         jitInfo->spillMemUsed = spillMemUsed;
+        jitInfo->spillMemUnshared = std::max(unsharedSpillSize, spillMemUsed);
         jitInfo->numGRFSpillFill = GRFSpillFillCount;
         jitInfo->numBytesScratchGtpin = kernel.getGTPinData()->getNumBytesScratchUse();
     }
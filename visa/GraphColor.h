@@ -345,7 +345,9 @@ namespace vISA
         // we don't directly update spraseIntf to ensure uniqueness
         // like dense matrix, interference is not symmetric (that is, if v1 and v2 interfere and v1 < v2,
         // we insert (v1, v2) but not (v2, v1)) for better cache behavior
-        std::vector<std::unordered_set<uint32_t> > sparseMatrix;
+        // each row only stores the chunks with at least one neighbor, so whole
+        // words of the live set can be merged into it as in the dense case
+        std::vector<SparseBitSet> sparseMatrix;
         const uint32_t denseMatrixLimit = 32768;
 
         void updateLiveness(BitSet& live, uint32_t id, bool val)
@@ -443,7 +445,7 @@ namespace vISA
             }
             else
             {
-                sparseMatrix[v1].emplace(v2);
+                sparseMatrix[v1].set(v2);
             }
         }
 
@@ -459,15 +461,7 @@ namespace vISA
             }
             else
             {
-                auto&& intfSet = sparseMatrix[v1];
-                for (int i = 0; i < BITS_DWORD; ++i)
-                {
-                    if (block & BitMask[i])
-                    {
-                        uint32_t v2 = col * BITS_DWORD + i;
-                        intfSet.emplace(v2);
-                    }
-                }
+                sparseMatrix[v1].setElt(col, block);
             }
         }
 
@@ -410,17 +410,20 @@ struct SchedConfig
         MASK_LATENCY      = 1U << 1,
         MASK_SETHI_ULLMAN = 1U << 2,
         MASK_CLUSTTERING  = 1U << 3,
+        MASK_SELECTION    = 1U << 4,
     };
     unsigned Dump : 1;
     unsigned UseLatency : 1;
     unsigned UseSethiUllman : 1;
     unsigned DoClustering : 1;
+    unsigned UseSelection : 1;
 
     explicit SchedConfig(unsigned Config)
         : Dump((Config & MASK_DUMP) != 0)
         , UseLatency((Config & MASK_LATENCY) != 0)
         , UseSethiUllman((Config & MASK_SETHI_ULLMAN) != 0)
         , DoClustering((Config & MASK_CLUSTTERING) != 0)
+        , UseSelection((Config & MASK_SELECTION) != 0)
     {
     }
 };
@@ -470,16 +473,26 @@ public:
 
     // Run list scheduling.
     void scheduleBlockForPressure() { SethiUllmanScheduling(); }
-    void scheduleBlockForLatency() { LatencyScheduling(); }
+    void scheduleBlockForLatency(unsigned Budget) { LatencyScheduling(Budget); }
 
     // Commit this scheduling if it reduces register pressure.
     bool commitIfBeneficial(unsigned &MaxRPE, bool IsTopDown);
 
+    // Schedule with each strategy, and commit the one with the best
+    // estimated pressure and cycles, if it is better than the current order.
+    bool scheduleBlockWithSelection(unsigned &MaxRPE);
+
 private:
     void SethiUllmanScheduling();
-    void LatencyScheduling();
+    void LatencyScheduling(unsigned Budget);
     bool verifyScheduling();
 
+    // Replace the block's instructions with Insts and update pressure.
+    void applySchedule(const std::vector<G4_INST*>& Insts);
+
+    // Estimate the cycles to issue this block in its current order.
+    unsigned estimateCycles();
+
     // Relocate pseudo-kills right before its successors.
     void relocatePseudoKills();
 };
@@ -512,6 +525,22 @@ static unsigned getLatencyHidingThreshold(G4_Kernel &kernel)
     return unsigned(LATENCY_PRESSURE_THRESHOLD * Ratio);
 }
 
+// Return the number of long latency messages in this block.
+static unsigned getNumHighLatencyInsts(G4_BB* bb)
+{
+    unsigned NumOfHighLatencyInsts = 0;
+    for (auto Inst : *bb) {
+        if (Inst->isSend()) {
+            G4_SendMsgDescriptor* MsgDesc = Inst->getMsgDesc();
+            if (MsgDesc->isDataPortRead() ||
+                MsgDesc->isSampler() ||
+                MsgDesc->isAtomicMessage())
+                NumOfHighLatencyInsts++;
+        }
+    }
+    return NumOfHighLatencyInsts;
+}
+
 preRA_Scheduler::preRA_Scheduler(G4_Kernel& k, Mem_Manager& m, RPE* rpe)
     : kernel(k)
     , mem(m)
@@ -552,6 +581,22 @@ bool preRA_Scheduler::run()
             continue;
         }
 
+        if (config.UseSelection &&
+            MaxPressure >= getLatencyHidingThreshold(kernel)) {
+            // Blocks close to the GRF limit have to trade latency for
+            // pressure, let the cost model pick among the enabled strategies.
+            SCHED_DUMP(rp.dump(bb, "Before scheduling, "));
+            preDDD ddd(mem, kernel, bb);
+            BB_Scheduler S(kernel, ddd, rp, config, LT);
+            if (S.scheduleBlockWithSelection(MaxPressure)) {
+                SCHED_DUMP(rp.dump(bb, "After scheduling with selection, "));
+                Changed = true;
+                kernel.fg.builder->getcompilerStats().SetFlag("PreRASchedulerWithSelection",
+                                                              this->kernel.getSimdSize());
+            }
+            continue;
+        }
+
         SCHED_DUMP(rp.dump(bb, "Before scheduling, "));
         preDDD ddd(mem, kernel, bb);
         BB_Scheduler S(kernel, ddd, rp, config, LT);
@@ -581,23 +626,12 @@ bool preRA_Scheduler::run()
                 return false;
 
             // simple ROI check.
-            unsigned NumOfHighLatencyInsts = 0;
-            for (auto Inst : *bb) {
-                if (Inst->isSend()) {
-                    G4_SendMsgDescriptor* MsgDesc = Inst->getMsgDesc();
-                    if (MsgDesc->isDataPortRead() ||
-                        MsgDesc->isSampler() ||
-                        MsgDesc->isAtomicMessage())
-                        NumOfHighLatencyInsts++;
-                }
-            }
-
-            return NumOfHighLatencyInsts >= 2;
+            return getNumHighLatencyInsts(bb) >= 2;
         };
 
         if (tryLatencyHiding()) {
             ddd.reset(Changed);
-            S.scheduleBlockForLatency();
+            S.scheduleBlockForLatency(getLatencyHidingThreshold(kernel));
             if (S.commitIfBeneficial(MaxPressure, /*IsTopDown*/ true)) {
                 SCHED_DUMP(rp.dump(bb, "After scheduling for latency, "));
                 Changed = true;
@@ -1079,11 +1113,15 @@ class LatencyQueue : public QueueBase {
     // Instrction latency information.
     const LatencyTable &LT;
 
+    // Pressure limit when grouping instructions.
+    unsigned Budget;
+
 public:
     LatencyQueue(preDDD& ddd, RegisterPressure& rp, SchedConfig config,
-        const LatencyTable& LT)
+        const LatencyTable& LT, unsigned Budget)
         : QueueBase(ddd, rp, config)
         , LT(LT)
+        , Budget(Budget)
     {
         init();
     }
@@ -1132,10 +1170,10 @@ private:
 
 // Scheduling block to hide latency (top down).
 //
-void BB_Scheduler::LatencyScheduling()
+void BB_Scheduler::LatencyScheduling(unsigned Budget)
 {
     schedule.clear();
-    LatencyQueue Q(ddd, rp, config, LT);
+    LatencyQueue Q(ddd, rp, config, LT, Budget);
     Q.push(ddd.getEntryNode());
 
     while (!Q.empty()) {
@@ -1293,8 +1331,7 @@ void LatencyQueue::init()
         // and starts a new group.
         //
         std::vector<unsigned> Segments;
-        unsigned Threshold = getLatencyHidingThreshold(ddd.getKernel());
-        mergeSegments(RPtrace, Max, Min, Segments, Threshold);
+        mergeSegments(RPtrace, Max, Min, Segments, Budget);
 
         // Iterate segments and assign a group id to each insstruction.
         unsigned i = 0;
@@ -1596,6 +1633,154 @@ bool BB_Scheduler::commitIfBeneficial(unsigned& MaxRPE, bool IsTopDown)
     return false;
 }
 
+void BB_Scheduler::applySchedule(const std::vector<G4_INST*>& Insts)
+{
+    INST_LIST& CurInsts = getBB()->getInstList();
+    CurInsts.clear();
+    CurInsts.insert(CurInsts.end(), Insts.begin(), Insts.end());
+    rp.recompute(getBB());
+}
+
+unsigned BB_Scheduler::estimateCycles()
+{
+    // Issue one instruction per cycle in order, stalling until the results
+    // of its data predecessors are available.
+    std::unordered_map<G4_INST*, preNode*> NodeMap;
+    for (auto N : ddd.getNodes())
+        if (N->getInst())
+            NodeMap[N->getInst()] = N;
+
+    std::unordered_map<preNode*, unsigned> IssueCycle;
+    unsigned Cycle = 0;
+    unsigned Last = 0;
+    for (auto Inst : *getBB()) {
+        if (Inst->isPseudoKill())
+            continue;
+        auto I = NodeMap.find(Inst);
+        if (I == NodeMap.end())
+            continue;
+        preNode* N = I->second;
+        unsigned Ready = Cycle;
+        for (auto& Edge : N->preds()) {
+            auto J = IssueCycle.find(Edge.getNode());
+            if (J == IssueCycle.end())
+                continue;
+            unsigned Latency = 1;
+            if (Edge.getType() == RAW || Edge.getType() == RAW_MEMORY)
+                Latency = LT.getLatency(Edge.getNode()->getInst());
+            Ready = std::max(Ready, J->second + Latency);
+        }
+        IssueCycle[N] = Ready;
+        Cycle = Ready + 1;
+        Last = std::max(Last, Ready + LT.getLatency(Inst));
+    }
+
+    return std::max(Cycle, Last);
+}
+
+bool BB_Scheduler::scheduleBlockWithSelection(unsigned& MaxRPE)
+{
+    struct Candidate {
+        const char* Name;
+        std::vector<G4_INST*> Insts;
+        unsigned MaxRPE;
+        unsigned Cycles;
+        bool IsTopDown;
+    };
+
+    INST_LIST& CurInsts = getBB()->getInstList();
+    ddd.buildGraph();
+
+    Candidate Orig = { "original",
+        std::vector<G4_INST*>(CurInsts.begin(), CurInsts.end()),
+        MaxRPE, estimateCycles(), true };
+    std::vector<Candidate> Candidates;
+
+    // Evaluate the schedule just computed, IsTopDown tells its order.
+    auto addCandidate = [&](const char* Name, bool IsTopDown) {
+        if (schedule.size() != CurInsts.size()) {
+            SCHED_DUMP(std::cerr << Name << " schedule dropped due to mischeduling.\n");
+            return false;
+        }
+        Candidate C = { Name, schedule, 0, 0, IsTopDown };
+        if (!IsTopDown)
+            std::reverse(C.Insts.begin(), C.Insts.end());
+        applySchedule(C.Insts);
+        C.MaxRPE = rp.getPressure(getBB());
+        C.Cycles = estimateCycles();
+        SCHED_DUMP(std::cerr << Name << " schedule: rp " << C.MaxRPE
+            << ", cycles " << C.Cycles << "\n");
+        Candidates.push_back(C);
+        return true;
+    };
+
+    unsigned LatencyThreshold = getLatencyHidingThreshold(kernel);
+    bool TryPressure = config.UseSethiUllman &&
+        MaxRPE >= getRPReductionThreshold(kernel);
+    bool TryLatency = config.UseLatency &&
+        getNumHighLatencyInsts(getBB()) >= 2;
+
+    // Pressure first, and a hybrid that hides latency on top of it within
+    // the pressure budget of rp reduction.
+    bool HasPressure = false;
+    if (TryPressure) {
+        scheduleBlockForPressure();
+        HasPressure = addCandidate("pressure", /*IsTopDown*/ false);
+    }
+    if (HasPressure && TryLatency) {
+        ddd.reset(true);
+        scheduleBlockForLatency(getRPReductionThreshold(kernel));
+        addCandidate("hybrid", /*IsTopDown*/ true);
+    }
+
+    // Latency first.
+    if (TryLatency) {
+        applySchedule(Orig.Insts);
+        if (TryPressure)
+            ddd.reset(true);
+        scheduleBlockForLatency(LatencyThreshold);
+        addCandidate("latency", /*IsTopDown*/ true);
+    }
+
+    // Pressure under the latency threshold does not cause spills, so only
+    // the part above it is weighed against cycles.
+    auto RPCost = [=](const Candidate& C) {
+        return std::max(C.MaxRPE, LatencyThreshold);
+    };
+    std::stable_sort(Candidates.begin(), Candidates.end(),
+        [&](const Candidate& C1, const Candidate& C2) {
+            if (RPCost(C1) != RPCost(C2))
+                return RPCost(C1) < RPCost(C2);
+            if (C1.Cycles != C2.Cycles)
+                return C1.Cycles < C2.Cycles;
+            return C1.MaxRPE < C2.MaxRPE;
+        });
+
+    // As in commitIfBeneficial, simd32 kernels that may still fall back to
+    // simd16 only take a pressure-first schedule that gets below the latency
+    // threshold, since slicing tends to hurt latency hiding.
+    bool ConservativeRPReduction = kernel.getSimdSize() == 32 &&
+        kernel.getOptions()->getOption(vISA_AbortOnSpill);
+
+    for (auto& C : Candidates) {
+        if (ConservativeRPReduction && !C.IsTopDown && C.MaxRPE >= LatencyThreshold)
+            continue;
+        bool LessPressure = RPCost(C) + PRESSURE_REDUCTION_MIN_BENEFIT <= RPCost(Orig);
+        bool FasterNoWorse = RPCost(C) <= RPCost(Orig) && C.Cycles < Orig.Cycles;
+        if ((LessPressure || FasterNoWorse) &&
+            !std::equal(C.Insts.begin(), C.Insts.end(), Orig.Insts.begin())) {
+            SCHED_DUMP(std::cerr << C.Name << " schedule committed.\n\n");
+            applySchedule(C.Insts);
+            MaxRPE = C.MaxRPE;
+            return true;
+        }
+    }
+
+    SCHED_DUMP(std::cerr << "schedule reverted, no better candidate.\n\n");
+    applySchedule(Orig.Insts);
+    return false;
+}
+
 // Implementation of preNode.
 preNode::~preNode() {}
 
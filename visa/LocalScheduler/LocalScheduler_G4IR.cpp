@@ -33,10 +33,217 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Timer.h"
 #include "visa_wa.h"
 #include <queue>
+#include <atomic>
+#include <thread>
+#include <tuple>
 
 using namespace std;
 using namespace vISA;
 
+// Return the GRFs touched by opnd after RA, if it is in the GRF file.
+static bool getGRFRange(G4_Operand* opnd, unsigned& first, unsigned& last)
+{
+    if (!opnd || opnd->isImm() || opnd->isLabel() || !opnd->getBase())
+    {
+        return false;
+    }
+    G4_VarBase* base = opnd->getBase();
+    G4_VarBase* phyReg = base->isRegVar() ? base->asRegVar()->getPhyReg() : base;
+    if (!phyReg || !phyReg->isGreg())
+    {
+        return false;
+    }
+    first = opnd->getLinearizedStart() / G4_GRF_REG_NBYTES;
+    last = opnd->getLinearizedEnd() / G4_GRF_REG_NBYTES;
+    return true;
+}
+
+// Traces need GRF liveness across blocks, which is only computed for
+// kernels without calls or indirect register accesses.
+static bool canScheduleTraces(FlowGraph& fg)
+{
+    for (auto bb : fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isCall() || inst->isFCall() ||
+                inst->isReturn() || inst->isFReturn() ||
+                (inst->opcode() == G4_jmpi && !inst->getSrc(0)->isLabel()))
+            {
+                return false;
+            }
+            G4_DstRegRegion* dst = inst->getDst();
+            if (dst && dst->isIndirect())
+            {
+                return false;
+            }
+            for (int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                G4_Operand* src = inst->getSrc(i);
+                if (src && src->isSrcRegRegion() && src->asSrcRegRegion()->isIndirect())
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Compute the GRFs live into each block after RA. Only unpredicated NoMask
+// writes of whole GRFs kill, so this over-approximates liveness.
+static void computeGRFLiveIn(FlowGraph& fg, unsigned numGRF, std::vector<BitSet>& liveIn)
+{
+    unsigned numBBs = 0;
+    for (auto bb : fg)
+    {
+        numBBs = std::max(numBBs, bb->getId() + 1);
+    }
+    std::vector<BitSet> use(numBBs, BitSet(numGRF, false));
+    std::vector<BitSet> def(numBBs, BitSet(numGRF, false));
+    liveIn.assign(numBBs, BitSet(numGRF, false));
+
+    for (auto bb : fg)
+    {
+        BitSet& bbUse = use[bb->getId()];
+        BitSet& bbDef = def[bb->getId()];
+        for (auto it = bb->rbegin(), ie = bb->rend(); it != ie; ++it)
+        {
+            G4_INST* inst = *it;
+            G4_DstRegRegion* dst = inst->getDst();
+            unsigned first = 0, last = 0;
+            if (dst && !inst->getPredicate() && inst->isWriteEnableInst() &&
+                (inst->getExecSize() == 1 || dst->getHorzStride() == 1) &&
+                getGRFRange(dst, first, last))
+            {
+                // only GRFs written as a whole
+                unsigned firstFull = (dst->getLinearizedStart() + G4_GRF_REG_NBYTES - 1) / G4_GRF_REG_NBYTES;
+                unsigned endFull = (dst->getLinearizedEnd() + 1) / G4_GRF_REG_NBYTES;
+                for (unsigned i = firstFull; i < endFull && i < numGRF; i++)
+                {
+                    bbDef.set(i, true);
+                    bbUse.set(i, false);
+                }
+            }
+            for (int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                if (getGRFRange(inst->getSrc(i), first, last))
+                {
+                    bbUse.set(first, std::min(last, numGRF - 1));
+                }
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto it = fg.rbegin(), ie = fg.rend(); it != ie; ++it)
+        {
+            G4_BB* bb = *it;
+            BitSet live(numGRF, false);
+            for (auto succ : bb->Succs)
+            {
+                live |= liveIn[succ->getId()];
+            }
+            live -= def[bb->getId()];
+            live |= use[bb->getId()];
+            if (live != liveIn[bb->getId()])
+            {
+                liveIn[bb->getId()].swap(live);
+                changed = true;
+            }
+        }
+    }
+}
+
+// Return true if inst may run on the path to a branch target where it was
+// not executed before: it has no side effect, only writes GRFs not live
+// at the target and does not read state that depends on its position.
+static bool isSpeculable(G4_INST* inst, const BitSet& liveAtTarget)
+{
+    if (inst->isSend())
+    {
+        if (!inst->getMsgDesc()->isSampler() || inst->isEOT())
+            return false;
+    }
+    else if (inst->isFlowControl() || inst->isLabel() || inst->isWait())
+    {
+        return false;
+    }
+
+    if (inst->getCondMod() || inst->getImplAccDst() || inst->getImplAccSrc() ||
+        inst->isAccDstInst() || inst->isAccSrcInst())
+    {
+        return false;
+    }
+
+    for (int i = 0; i < G4_MAX_SRCS; i++)
+    {
+        G4_Operand* src = inst->getSrc(i);
+        if (src && src->isSrcRegRegion() && src->isAreg() && !src->isNullReg())
+            return false;
+    }
+
+    unsigned first = 0, last = 0;
+    if (!getGRFRange(inst->getDst(), first, last))
+        return false;
+    return liveAtTarget.isEmpty(first, last);
+}
+
+// Pair blocks ending with a predicated jmpi with their fall-through block
+// when that has no other predecessor. A block is in at most one trace.
+static void formTraces(FlowGraph& fg, std::list<SchedTrace>& traces)
+{
+    unsigned numGRF = fg.getKernel()->getNumRegTotal();
+    unsigned windowSize = fg.builder->getOptions()->getuInt32Option(vISA_SchedulerWindowSize);
+    std::vector<BitSet> liveIn;
+    computeGRFLiveIn(fg, numGRF, liveIn);
+
+    G4_BB* lastTail = nullptr;
+    for (auto it = fg.begin(), ie = fg.end(); it != ie && std::next(it) != ie; ++it)
+    {
+        G4_BB* head = *it;
+        G4_BB* tail = *std::next(it);
+        if (head == lastTail || head->empty() || tail->empty() ||
+            !tail->front()->isLabel())
+        {
+            continue;
+        }
+        G4_INST* branch = head->back();
+        if (branch->opcode() != G4_jmpi || !branch->getPredicate() ||
+            head->Succs.size() != 2 || tail->Preds.size() != 1 ||
+            tail->Preds.front() != head)
+        {
+            continue;
+        }
+        G4_BB* target = head->Succs.front() == tail ? head->Succs.back() : head->Succs.front();
+        if (target == tail ||
+            (windowSize > 0 && head->size() + tail->size() > windowSize))
+        {
+            continue;
+        }
+
+        SchedTrace trace;
+        trace.head = head;
+        trace.tail = tail;
+        trace.branch = branch;
+        for (auto inst : *tail)
+        {
+            if (isSpeculable(inst, liveIn[target->getId()]))
+            {
+                trace.speculable.insert(inst);
+            }
+        }
+        if (!trace.speculable.empty())
+        {
+            traces.push_back(std::move(trace));
+            lastTail = tail;
+        }
+    }
+}
+
 /* Entry to the local scheduling. */
 void LocalScheduler::localScheduling()
 {
@@ -51,8 +258,36 @@ void LocalScheduler::localScheduling()
     const Options *m_options = fg.builder->getOptions();
     LatencyTable LT(fg.builder);
 
+    // BBs that are scheduled as a whole, with their slot in bbInfo
+    std::vector<std::pair<G4_BB*, int>> blocks;
+
+    // Pairs of BBs scheduled as one region, with the region holding their
+    // instructions and the slot of the head in bbInfo
+    std::list<SchedTrace> traces;
+    std::vector<std::tuple<SchedTrace*, G4_BB*, int>> traceRegions;
+    if (m_options->getOption(vISA_TraceScheduling) && canScheduleTraces(fg))
+    {
+        formTraces(fg, traces);
+    }
+    auto traceIt = traces.begin();
+
     for (; ib != bend; ++ib)
     {
+        if (traceIt != traces.end() && traceIt->head == *ib)
+        {
+            G4_BB* region = fg.createNewBB(false);
+            region->splice(region->end(), traceIt->head,
+                traceIt->head->begin(), traceIt->head->end());
+            region->splice(region->end(), traceIt->tail,
+                std::next(traceIt->tail->begin()), traceIt->tail->end());
+            traceRegions.push_back(std::make_tuple(&*traceIt, region, i));
+            // the tail is the next BB and takes the next slot
+            ++traceIt;
+            ++ib;
+            i += 2;
+            continue;
+        }
+
         unsigned instCountBefore = (uint32_t)(*ib)->size();
         #define SCH_THRESHOLD 2
         if (instCountBefore < SCH_THRESHOLD)
@@ -60,7 +295,6 @@ void LocalScheduler::localScheduling()
             continue;
         }
 
-        Mem_Manager bbMem(4096);
         unsigned schedulerWindowSize = m_options->getuInt32Option(vISA_SchedulerWindowSize);
         if (schedulerWindowSize > 0 && instCountBefore > schedulerWindowSize)
         {
@@ -68,6 +302,7 @@ void LocalScheduler::localScheduling()
             // traversing DAG in list scheduler, stack overflow occurs.
             // So artificially breakup inst list here to reduce size
             // of scheduler problem size.
+            Mem_Manager bbMem(4096);
             unsigned int count = 0;
             std::vector<G4_BB*> sections;
 
@@ -100,15 +335,108 @@ void LocalScheduler::localScheduling()
         }
         else
         {
-            G4_BB_Schedule schedule(fg.getKernel(), bbMem, *ib, LT);
-            bbInfo[i].id = (*ib)->getId();
-            bbInfo[i].staticCycle = schedule.sequentialCycle;
-            bbInfo[i].sendStallCycle = schedule.sendStallCycle;
-            bbInfo[i].loopNestLevel = (*ib)->getNestLevel();
+            blocks.push_back(std::make_pair(*ib, i));
         }
 
         i++;
     }
+
+    auto scheduleBlock = [this, &LT, bbInfo](G4_BB* bb, int slot)
+    {
+        Mem_Manager bbMem(4096);
+        G4_BB_Schedule schedule(fg.getKernel(), bbMem, bb, LT);
+        bbInfo[slot].id = bb->getId();
+        bbInfo[slot].staticCycle = schedule.sequentialCycle;
+        bbInfo[slot].sendStallCycle = schedule.sendStallCycle;
+        bbInfo[slot].loopNestLevel = bb->getNestLevel();
+    };
+
+    auto scheduleTrace = [this, &LT, bbInfo](SchedTrace* trace, G4_BB* region, int slot)
+    {
+        Mem_Manager bbMem(4096);
+        G4_BB_Schedule schedule(fg.getKernel(), bbMem, region, LT, trace);
+
+        // Split the region after the branch; speculated instructions are now
+        // in the head.
+        auto branchIt = std::find(region->begin(), region->end(), trace->branch);
+        trace->head->splice(trace->head->end(), region, region->begin(), std::next(branchIt));
+        trace->tail->splice(trace->tail->end(), region, region->begin(), region->end());
+
+        // Cycles of the region are accounted to the head.
+        bbInfo[slot].id = trace->head->getId();
+        bbInfo[slot].staticCycle = schedule.sequentialCycle;
+        bbInfo[slot].sendStallCycle = schedule.sendStallCycle;
+        bbInfo[slot].loopNestLevel = trace->head->getNestLevel();
+        bbInfo[slot + 1].id = trace->tail->getId();
+        bbInfo[slot + 1].loopNestLevel = trace->tail->getNestLevel();
+    };
+
+    for (auto& region : traceRegions)
+    {
+        scheduleTrace(std::get<0>(region), std::get<1>(region), std::get<2>(region));
+    }
+
+    unsigned numThreads = m_options->getuInt32Option(vISA_LocalSchedThreads);
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (m_options->getOption(vISA_DumpSchedule) || m_options->getOption(vISA_DumpDot))
+    {
+        // keep the dumps in BB order
+        numThreads = 1;
+    }
+    numThreads = std::min(numThreads, (unsigned)blocks.size());
+
+    if (numThreads <= 1)
+    {
+        for (auto& block : blocks)
+        {
+            scheduleBlock(block.first, block.second);
+        }
+    }
+    else
+    {
+        // Blocks are independent: each one gets its own DDD and arena, and the
+        // new order is written back into its own instruction list without
+        // allocating list nodes. Start with the largest blocks so that one big
+        // block scheduled last does not serialize the tail.
+        std::stable_sort(blocks.begin(), blocks.end(),
+            [](const std::pair<G4_BB*, int>& a, const std::pair<G4_BB*, int>& b)
+            {
+                return a.first->size() > b.first->size();
+            });
+
+        std::atomic<size_t> nextBlock(0);
+        auto scheduleBlocks = [&]()
+        {
+            for (size_t b = nextBlock++; b < blocks.size(); b = nextBlock++)
+            {
+                scheduleBlock(blocks[b].first, blocks[b].second);
+            }
+        };
+
+        TARGET_PLATFORM platform = getGenxPlatform();
+        std::string stepping = GetSteppingString();
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < numThreads; ++t)
+        {
+            workers.emplace_back([&]()
+            {
+                // the platform and stepping globals are per thread
+                SetVisaPlatform(platform);
+                InitStepping();
+                SetStepping(stepping.c_str());
+                scheduleBlocks();
+            });
+        }
+        scheduleBlocks();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
     FINALIZER_INFO* jitInfo = fg.builder->getJitInfo();
     jitInfo->BBInfo = bbInfo;
     jitInfo->BBNum = i;
@@ -201,7 +529,7 @@ void G4_BB_Schedule::dumpSchedule(G4_BB *bb)
 //      - creates a new instruction listing within a BBB
 //
 G4_BB_Schedule::G4_BB_Schedule(G4_Kernel* k, Mem_Manager& m, G4_BB* block,
-    const LatencyTable& LT)
+    const LatencyTable& LT, const SchedTrace* trace)
     : kernel(k)
     , mem(m)
     , bb(block)
@@ -210,10 +538,12 @@ G4_BB_Schedule::G4_BB_Schedule(G4_Kernel* k, Mem_Manager& m, G4_BB* block,
     // we use local id in the scheduler for determining two instructions' original ordering
     bb->resetLocalId();
 
-    DDD ddd(mem, bb, LT, k);
-    // Generate pairs of TypedWrites
-    bool doMessageFuse = (k->fg.builder->fuseTypedWrites() && k->getSimdSize() >= 16) ||
-        k->fg.builder->fuseURBMessage();
+    DDD ddd(mem, bb, LT, k, trace);
+    // Generate pairs of TypedWrites. Not for traces, as a pair could
+    // straddle the branch.
+    bool doMessageFuse = !trace &&
+        ((k->fg.builder->fuseTypedWrites() && k->getSimdSize() >= 16) ||
+        k->fg.builder->fuseURBMessage());
 
     if (doMessageFuse)
     {
@@ -489,176 +819,53 @@ bool DDD::getBucketDescrs(Node *node, std::vector<BucketDescr>& BDvec)
 class LiveBuckets
 {
     std::vector<BucketHeadNode> nodeBucketsArray;
-    DDD *ddd;
-    int firstBucket;
-    int numOfBuckets;
-    friend class BN_iterator;
-    static const bool ALL_BUCKETS = true;
-
-public:
-    class BN_iterator
-    {
-    public:
-        const LiveBuckets *LB;
-        BUCKET_VECTOR_ITER node_it;
-        int bucket;
-        bool iterateAll;
-
-        BN_iterator(const LiveBuckets *LB1, BUCKET_VECTOR_ITER It, int Bucket,
-            bool All)
-            : LB(LB1), node_it(It), bucket(Bucket), iterateAll(All) {
-            ;
-        }
 
+    // Buckets that had a node added since the last clearAllLive(), so that
+    // barriers and clearing do not need to visit every bucket.
+    std::vector<int> touchedBuckets;
 
-        void skipEmptyBuckets() {
-            // If at the end of the node vector, move to next bucket
-            // Keep going until a non-empty vector is found
-            while (bucket < LB->numOfBuckets
-                && node_it == LB->nodeBucketsArray[bucket].bucketVec->end())
-            {
-                bucket++;
-                if (bucket < LB->numOfBuckets)
-                {
-                    node_it = LB->nodeBucketsArray[bucket].bucketVec->begin();
-                }
-            }
-        }
-
-        // The iterator supports 2 modes of operation:
-        // 1) Iterate across the vector nodes of a single bucket
-        // 2) Iterate across all buckets and all vector nodes of each bucket
-        BN_iterator &operator++() {
-            // Mode 1
-            if (iterateAll == LiveBuckets::ALL_BUCKETS)
-            {
-                auto node_ite = LB->nodeBucketsArray[bucket].bucketVec->end();
-                // Increment node vector iterator
-                if (node_it != node_ite)
-                {
-                    ++node_it;
-                }
-                skipEmptyBuckets();
-            }
-            // Mode 2
-            else
-            {
-                ++node_it;
-            }
-            assert(!iterateAll
-                || bucket == LB->numOfBuckets
-                || node_it != LB->nodeBucketsArray[bucket].bucketVec->end());
-            return *this;
-        }
-        bool operator==(const BN_iterator &it2) {
-            assert(LB == it2.LB && iterateAll == it2.iterateAll);
-            // NOTE: order of comparisons matters: if different buckets
-            //       then node_its are of different vectors
-            return (bucket == it2.bucket && node_it == it2.node_it);
-        }
-        bool operator!=(const BN_iterator &it2) {
-            assert(LB == it2.LB && iterateAll == it2.iterateAll);
-            return (!(*this == it2));
-        }
-        BucketNode *operator*() {
-            assert(node_it != LB->nodeBucketsArray[bucket].bucketVec->end());
-            return *node_it;
-        }
-    };
-
-    LiveBuckets(DDD *Ddd, int GRF_BUCKET, int TOTAL_BUCKETS) {
-        firstBucket = GRF_BUCKET;
-        numOfBuckets = TOTAL_BUCKETS;
-        ddd = Ddd;
-        nodeBucketsArray.resize(numOfBuckets);
-
-        // Initialize a vector for each bucket
-        for (int bucket_i = 0; bucket_i != (int)numOfBuckets; ++bucket_i)
-        {
-            void* allocedMem = ddd->get_mem()->alloc(sizeof(BUCKET_VECTOR));
-            nodeBucketsArray[bucket_i].bucketVec
-                = new (allocedMem)BUCKET_VECTOR();
-        }
-    }
-
-    ~LiveBuckets() {
-        for (int i = 0; i < numOfBuckets; i++) {
-            BucketHeadNode &BHN = nodeBucketsArray[i];
-            if (BHN.bucketVec) {
-                BHN.bucketVec->~BUCKET_VECTOR();
-            }
-        }
-    }
-
-    // Mode 1: Iterate across nodes in BUCKET
-    BN_iterator begin(int bucket) const {
-        return BN_iterator(this, nodeBucketsArray[bucket].bucketVec->begin(),
-            bucket, !ALL_BUCKETS);
-    }
-
-    // Mode 1:
-    BN_iterator end(int bucket) const {
-        return BN_iterator(this, nodeBucketsArray[bucket].bucketVec->end(),
-            bucket, !ALL_BUCKETS);
-    }
-
-    // Mode 2: Iterate across all nodes and all buckets
-    BN_iterator begin() const {
-        auto it = BN_iterator(this,
-            nodeBucketsArray[firstBucket].bucketVec->begin(),
-            firstBucket, ALL_BUCKETS);
-        it.skipEmptyBuckets();
-        return it;
-    }
+public:
+    LiveBuckets(int TOTAL_BUCKETS) : nodeBucketsArray(TOTAL_BUCKETS) {}
 
-    // Mode 2:
-    BN_iterator end() const {
-        return BN_iterator(this,
-            nodeBucketsArray[numOfBuckets - 1].bucketVec->end(),
-            numOfBuckets, ALL_BUCKETS);
+    static bool isWrite(Gen4_Operand_Number opndNum) {
+        return opndNum == Opnd_dst || opndNum == Opnd_implAccDst ||
+               opndNum == Opnd_condMod;
     }
 
-    void clearLive(int bucket) {
-        BucketHeadNode &BHNode = nodeBucketsArray[bucket];
-        BHNode.bucketVec->clear();
-    }
+    BucketHeadNode &getBucket(int bucket) { return nodeBucketsArray[bucket]; }
+    const std::vector<int> &getTouchedBuckets() const { return touchedBuckets; }
 
     void clearAllLive() {
-        for (int bucket_i = 0; bucket_i < numOfBuckets; ++bucket_i) {
-            clearLive(bucket_i);
+        for (int bucket : touchedBuckets) {
+            BucketHeadNode &BHNode = nodeBucketsArray[bucket];
+            BHNode.writes.clear();
+            BHNode.reads.clear();
+            BHNode.touched = false;
         }
+        touchedBuckets.clear();
     }
 
-    bool hasLive(const Mask &mask, int bucket) {
-        BucketHeadNode &BHNode = nodeBucketsArray[bucket];
-        auto BV = BHNode.bucketVec;
-        assert(BV != nullptr && "vectors not initialized?");
-        return (!BV->empty());
+    bool hasLive(int bucket) const {
+        const BucketHeadNode &BHNode = nodeBucketsArray[bucket];
+        return !BHNode.writes.empty() || !BHNode.reads.empty();
     }
 
-    void kill(Mask mask, BN_iterator &bn_it) {
-        BucketHeadNode &BHNode = nodeBucketsArray[bn_it.bucket];
-        BUCKET_VECTOR &vec = *BHNode.bucketVec;
-        BUCKET_VECTOR_ITER &node_it = bn_it.node_it;
-        if (*node_it == vec.back()) {
-            vec.pop_back();
-            node_it = vec.end();
-        } else {
-            *node_it = vec.back();
-            vec.pop_back();
-        }
+    // Remove the live node at index i. The order of live nodes is not kept.
+    static void kill(BUCKET_VECTOR &vec, size_t i) {
+        vec[i] = vec.back();
+        vec.pop_back();
     }
 
     // Create a bucket node for NODE using the information in BD
     // and append it to the list of live nodes.
     void add(Node *node, const BucketDescr &BD) {
         BucketHeadNode &BHNode = nodeBucketsArray[BD.bucket];
-        // Append the bucket node to the vector hanging from the header
-        assert(BHNode.bucketVec != nullptr);
-        BUCKET_VECTOR& nodeVec = *(BHNode.bucketVec);
-        void *allocedMem = ddd->get_mem()->alloc(sizeof(BucketNode));
-        BucketNode *newNode = new(allocedMem)BucketNode(node, BD.mask, BD.operand);
-        nodeVec.push_back(newNode);
+        if (!BHNode.touched) {
+            BHNode.touched = true;
+            touchedBuckets.push_back(BD.bucket);
+        }
+        BUCKET_VECTOR &nodeVec = isWrite(BD.operand) ? BHNode.writes : BHNode.reads;
+        nodeVec.emplace_back(node, BD.mask, BD.operand);
         // If it is a write to a subreg, mark the NODE accordingly
         if (BD.operand == Opnd_dst) {
             node->setWritesToSubreg(BD.bucket);
@@ -728,12 +935,20 @@ static DepType getDepForOpnd(Gen4_Operand_Number cur,
 // dependencies with all insts in live set. After analyzing
 // dependencies and creating necessary edges, current inst
 // is inserted in all buckets it touches.
-DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
+//
+// For a trace, bb holds the instructions of both blocks. The trace branch
+// is not a barrier: it is ordered after every head instruction and before
+// every tail instruction that may not be speculated, while the speculable
+// ones are only constrained by their data dependencies.
+DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k,
+    const SchedTrace* trace)
     : mem(m)
     , LT(lt)
     , kernel(k)
 {
     Node* lastBarrier = nullptr;
+    Node* traceBranch = nullptr;
+    std::vector<Node*> tailFixedNodes;
     HWthreadsPerEU = getBuilder()->getHWThreadNumberPerEU();
     useMTLatencies = getBuilder()->useMultiThreadLatency();
     totalGRFNum = kernel->getNumRegTotal();
@@ -749,7 +964,7 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
     OTHER_ARF_BUCKET = SCRATCH_SEND_BUCKET + 1;
     TOTAL_BUCKETS = OTHER_ARF_BUCKET + 1;
 
-    LiveBuckets LB(this, GRF_BUCKET, TOTAL_BUCKETS);
+    LiveBuckets LB(TOTAL_BUCKETS);
 
     // Building the graph in reverse relative to the original instruction
     // order, to naturally take care of the liveness of operands.
@@ -774,17 +989,39 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
             node->MarkAsUnresolvedIndirAddressBarrier();
         }
 
+        if (trace)
+        {
+            if (curInst == trace->branch)
+            {
+                node->barrier = NODEP;
+                traceBranch = node;
+            }
+            else if (traceBranch)
+            {
+                // Head instructions must not sink below the branch.
+                createAddEdge(node, traceBranch, CONTROL_FLOW_BARRIER);
+            }
+            else if (!trace->speculable.count(curInst))
+            {
+                tailFixedNodes.push_back(node);
+            }
+        }
+
         DepType  depType;
         if ((depType = node->isLabel()) || (depType = node->isBarrier()))
         {
             // Insert edge from current instruction
             // to all instructions live in every bucket
-            for (auto it = LB.begin(), ite = LB.end(); it != ite; ++it) {
-                BucketNode *BNode = *it;
-                Node* liveNode = BNode->node;
-                if (liveNode->preds.empty())
-                {
-                    createAddEdge(node, liveNode, depType);
+            for (int bucket : LB.getTouchedBuckets()) {
+                BucketHeadNode &BHNode = LB.getBucket(bucket);
+                for (BUCKET_VECTOR *liveVec : { &BHNode.writes, &BHNode.reads }) {
+                    for (BucketNode &BNode : *liveVec) {
+                        Node* liveNode = BNode.node;
+                        if (liveNode->preds.empty())
+                        {
+                            createAddEdge(node, liveNode, depType);
+                        }
+                    }
                 }
             }
             LB.clearAllLive();
@@ -803,7 +1040,7 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
                 const int &curBucket = BD.bucket;
                 const Gen4_Operand_Number &curOpnd = BD.operand;
                 const Mask &curMask = BD.mask;
-                if (!LB.hasLive(curMask, curBucket)) {
+                if (!LB.hasLive(curBucket)) {
                     continue;
                 }
                 // Kill type 1: When the current destination region completely
@@ -814,65 +1051,74 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
                 // For each live curBucket node:
                 // i)  create edge if required
                 // ii) kill bucket node if required
-                for (LiveBuckets::BN_iterator bn_it = LB.begin(curBucket);
-                    bn_it != LB.end(curBucket);) {
-                    BucketNode *liveBN = (*bn_it);
-                    Node *curLiveNode = liveBN->node;
-                    Gen4_Operand_Number liveOpnd = liveBN->opndNum;
-                    Mask &liveMask = liveBN->mask;
-
-                    G4_INST *liveInst = *curLiveNode->getInstructions()->begin();
-                    // Kill type 2: When the current destination region covers
-                    //              the live node's region completely.
-                    bool curKillsLive = curMask.kills(liveMask);
-                    bool hasOverlap = curMask.hasOverlap(liveMask);
-
-                    // 1. Find DEP type
-                    DepType dep = DEPTYPE_MAX;
-                    if (curBucket < ACC_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                    } else if (curBucket == ACC_BUCKET
-                        || curBucket == A0_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                        curKillsBucket = false;
-                    } else if (curBucket == SEND_BUCKET) {
-                        dep = getDepSend(curInst, liveInst, getOptions(), BTIIsRestrict);
-                        hasOverlap = (dep != NODEP);
-                        curKillsBucket = false;
-                        curKillsLive = (dep == WAW_MEMORY || dep == RAW_MEMORY);
-                    } else if (curBucket == SCRATCH_SEND_BUCKET) {
-                        dep = getDepScratchSend(curInst, liveInst);
-                        hasOverlap = (dep != NODEP);
-                        curKillsBucket = false;
-                        curKillsLive = false; // Disable kill
-                    } else if (curBucket == FLAG0_BUCKET
-                        || curBucket == FLAG1_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                        curKillsBucket = false;
-                    } else if (curBucket == OTHER_ARF_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                        hasOverlap = (dep != NODEP); // Let's be conservative
-                        curKillsBucket = false;
-                    } else {
-                        assert(0 && "Bad bucket");
-                    }
+                auto checkLiveNodes = [&](BUCKET_VECTOR &liveVec) {
+                    for (size_t bn_i = 0; bn_i < liveVec.size();) {
+                        BucketNode &liveBN = liveVec[bn_i];
+                        Node *curLiveNode = liveBN.node;
+                        Gen4_Operand_Number liveOpnd = liveBN.opndNum;
+                        Mask &liveMask = liveBN.mask;
+
+                        G4_INST *liveInst = *curLiveNode->getInstructions()->begin();
+                        // Kill type 2: When the current destination region covers
+                        //              the live node's region completely.
+                        bool curKillsLive = curMask.kills(liveMask);
+                        bool hasOverlap = curMask.hasOverlap(liveMask);
+
+                        // 1. Find DEP type
+                        DepType dep = DEPTYPE_MAX;
+                        if (curBucket < ACC_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                        } else if (curBucket == ACC_BUCKET
+                            || curBucket == A0_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                            curKillsBucket = false;
+                        } else if (curBucket == SEND_BUCKET) {
+                            dep = getDepSend(curInst, liveInst, getOptions(), BTIIsRestrict);
+                            hasOverlap = (dep != NODEP);
+                            curKillsBucket = false;
+                            curKillsLive = (dep == WAW_MEMORY || dep == RAW_MEMORY);
+                        } else if (curBucket == SCRATCH_SEND_BUCKET) {
+                            dep = getDepScratchSend(curInst, liveInst);
+                            hasOverlap = (dep != NODEP);
+                            curKillsBucket = false;
+                            curKillsLive = false; // Disable kill
+                        } else if (curBucket == FLAG0_BUCKET
+                            || curBucket == FLAG1_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                            curKillsBucket = false;
+                        } else if (curBucket == OTHER_ARF_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                            hasOverlap = (dep != NODEP); // Let's be conservative
+                            curKillsBucket = false;
+                        } else {
+                            assert(0 && "Bad bucket");
+                        }
 
-                    // 2. Create Edge if there is overlap and RAW/WAW/WAR
-                    if (dep != NODEP && hasOverlap) {
-                        createAddEdge(node, curLiveNode, dep);
-                        transitiveEdgeToBarrier
-                            |= curLiveNode->hasTransitiveEdgeToBarrier;
-                    }
+                        // 2. Create Edge if there is overlap and RAW/WAW/WAR
+                        if (dep != NODEP && hasOverlap) {
+                            createAddEdge(node, curLiveNode, dep);
+                            transitiveEdgeToBarrier
+                                |= curLiveNode->hasTransitiveEdgeToBarrier;
+                        }
 
-                    // 3. Kill if required
-                    if ((dep == RAW || dep == RAW_MEMORY
-                        || dep == WAW || dep == WAW_MEMORY)
-                        && (curKillsBucket || curKillsLive)) {
-                        LB.kill(curMask, bn_it);
-                        continue;
+                        // 3. Kill if required
+                        if ((dep == RAW || dep == RAW_MEMORY
+                            || dep == WAW || dep == WAW_MEMORY)
+                            && (curKillsBucket || curKillsLive)) {
+                            LiveBuckets::kill(liveVec, bn_i);
+                            continue;
+                        }
+                        assert(dep != DEPTYPE_MAX && "dep unassigned?");
+                        ++bn_i;
                     }
-                    assert(dep != DEPTYPE_MAX && "dep unassigned?");
-                    ++bn_it;
+                };
+
+                // A read never depends on another read, so it is only checked
+                // against the live writes.
+                BucketHeadNode &BHNode = LB.getBucket(curBucket);
+                checkLiveNodes(BHNode.writes);
+                if (LiveBuckets::isWrite(curOpnd)) {
+                    checkLiveNodes(BHNode.reads);
                 }
             }
 
@@ -884,6 +1130,14 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
             }
         }
 
+        if (node == traceBranch)
+        {
+            for (Node* tailNode : tailFixedNodes)
+            {
+                createAddEdge(node, tailNode, CONTROL_FLOW_BARRIER);
+            }
+        }
+
         // Add buckets of current instruction to bucket list
         for (const BucketDescr &BD : BDvec)
         {
@@ -1204,8 +1458,9 @@ void DDD::setPriority(Node *pred, const Edge &edge)
 // The edge latency is also attached.
 void DDD::createAddEdge(Node* pred, Node* succ, DepType d)
 {
-    // Check whether an edge already exists
-    for (int i = 0; i < (int)(pred->succs.size()); i++)
+    // Check whether an edge already exists. Start from the most recent
+    // edge, which is the one hit by operands spanning several buckets.
+    for (int i = (int)(pred->succs.size()) - 1; i >= 0; i--)
     {
         Edge& curSucc = pred->succs[i];
         // Keep the deptype that has the highest latency
@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <string>
 #include <set>
 #include <bitset>
+#include <unordered_set>
 #include "../Mem_Manager.h"
 #include "../FlowGraph.h"
 #include "../BuildIR.h" // add IR_Builder and G4_Kernel objects to support the exit code patch and combined kernel
@@ -218,17 +219,16 @@ struct BucketNode {
         : node(node1), mask(mask1), opndNum(opndNum1) {}
 };
 
-typedef std::vector<BucketNode *> BUCKET_VECTOR;
-typedef BUCKET_VECTOR::iterator BUCKET_VECTOR_ITER;
+typedef std::vector<BucketNode> BUCKET_VECTOR;
 
-// This is the head node from which the list of live nodes hangs from.
-// There is a single head node per bucket.
+// This is the head node from which the lists of live nodes hang from.
+// There is a single head node per bucket. Reads and writes are kept
+// apart, as a read only needs to be checked against the live writes.
 struct BucketHeadNode {
-    // The list of live nodes hanging from this head node.
-    BUCKET_VECTOR *bucketVec;
-    // This is for future use. We can use it as an aggregate mask to avoid
-    // searching through the list.
-    Mask mask;
+    BUCKET_VECTOR writes;
+    BUCKET_VECTOR reads;
+    // Set while the bucket is in the touched list of LiveBuckets.
+    bool touched = false;
 };
 
 // Describes a single bucket access
@@ -243,6 +243,17 @@ struct BucketDescr {
         : bucket(Bucket), mask(Mask), operand(Operand) { ; }
 };
 
+// Two blocks scheduled as a single region. The head ends with a
+// predicated jmpi and falls through to the tail, which has no other
+// predecessor. Tail instructions in speculable may be moved above the
+// branch; everything else stays on its side of it.
+struct SchedTrace {
+    G4_BB* head = nullptr;
+    G4_BB* tail = nullptr;
+    G4_INST* branch = nullptr;
+    std::unordered_set<G4_INST*> speculable;
+};
+
 class DDD {
     std::vector<Node *> allNodes;
     Mem_Manager &mem;
@@ -274,7 +285,8 @@ public:
     void pairTypedWriteOrURBWriteNodes(G4_BB *bb);
 
 
-    DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k);
+    DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k,
+        const SchedTrace* trace = nullptr);
     ~DDD()
     {
         if (Nodes.size())
@@ -324,7 +336,7 @@ public:
 
     // Constructor
     G4_BB_Schedule(G4_Kernel* kernel, Mem_Manager& m, G4_BB* bb,
-        const LatencyTable& LT);
+        const LatencyTable& LT, const SchedTrace* trace = nullptr);
     void *operator new(size_t sz, Mem_Manager &m){ return m.alloc(sz); }
     // Dumps the schedule
     void emit(std::ostream &);
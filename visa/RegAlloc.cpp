@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "FlowGraph.h"
 #include "RegAlloc.h"
 #include <bitset>
+#include <functional>
 #include "GraphColor.h"
 #include "Timer.h"
 #include <fstream>
@@ -499,7 +500,11 @@ LivenessAnalysis::LivenessAnalysis(
     use_out.resize(numBBId);
     use_gen.resize(numBBId);
     use_kill.resize(numBBId);
-    indr_use.resize(numBBId);
+    if (verifyRA)
+    {
+        // indirect uses are only consulted by RA verification
+        indr_use.resize(numBBId);
+    }
 
     for (unsigned i = 0; i < numBBId; i++)
     {
@@ -509,7 +514,10 @@ LivenessAnalysis::LivenessAnalysis(
         use_out[i] = BitSet(numVarId, false);
         use_gen[i] = BitSet(numVarId, false);
         use_kill[i]= BitSet(numVarId, false);
-        indr_use[i]= BitSet(numVarId, false);
+    }
+    for (auto& indr : indr_use)
+    {
+        indr = BitSet(numVarId, false);
     }
 
     numFnId = (unsigned) fg.funcInfoTable.size();
@@ -759,7 +767,7 @@ void LivenessAnalysis::detectNeverDefinedVarRows()
 // uses of reg vars are anticipated, which tell use the uses of reg vars.Def and Use vectors encapsulate the liveness
 // of reg vars.
 //
-void LivenessAnalysis::computeLiveness()
+void LivenessAnalysis::computeLiveness(const LivenessSeed* seed)
 {
     //
     // no reg var is selected, then no need to compute liveness
@@ -890,7 +898,10 @@ void LivenessAnalysis::computeLiveness()
             for( unsigned i = 0; i < grfVecPtr->size(); i++ )
             {
                 G4_RegVar* addrTaken =(*grfVecPtr)[i];
-                indr_use[bb->getId()].set( addrTaken->getId(), true );
+                if (!indr_use.empty())
+                {
+                    indr_use[bb->getId()].set(addrTaken->getId(), true);
+                }
                 addr_taken.set(addrTaken->getId(), true);
             }
         }
@@ -1261,31 +1272,50 @@ void LivenessAnalysis::computeLiveness()
 #endif
         }
 
+        if (seed && !seed->empty())
+        {
+            applySeed(*seed);
+        }
+
         //
-        // backward flow analysis to propagate uses (locate last uses)
+        // Both analyses below are worklist driven: a BB is revisited only when one of
+        // its neighbors changed, and each sweep walks the dirty BBs in (reverse)
+        // post-order so most values settle in a single pass.
         //
+        std::vector<G4_BB*> rpo;
+        computeRPO(rpo);
+        std::vector<bool> dirty(numBBId, true);
 
+        //
+        // backward flow analysis to propagate uses (locate last uses)
+        //
         bool change = true;
-
         while (change)
         {
             change = false;
-            BB_LIST::iterator rit = fg.end();
-            do
+            for (auto rit = rpo.rbegin(), rend = rpo.rend(); rit != rend; ++rit)
             {
+                G4_BB* bb = *rit;
+                if (!dirty[bb->getId()])
+                {
+                    continue;
+                }
+                dirty[bb->getId()] = false;
+
                 //
                 // use_out = use_in(s1) + use_in(s2) + ...
                 // where s1 s2 ... are the successors of bb
                 // use_in  = use_gen + (use_out - use_kill)
                 //
-                --rit;
-                if (contextFreeUseAnalyze((*rit)))
+                if (contextFreeUseAnalyze(bb))
                 {
+                    for (auto pred : bb->Preds)
+                    {
+                        dirty[pred->getId()] = true;
+                    }
                     change = true;
                 }
-
             }
-            while (rit != fg.begin());
         }
 
         //
@@ -1296,18 +1326,29 @@ void LivenessAnalysis::computeLiveness()
         // initialize entry block with payload input
         //
         def_in[fg.getEntryBB()->getId()] = inputDefs;
+        dirty.assign(numBBId, true);
         change = true;
         while (change)
         {
             change = false;
-            for (auto bb : fg)
+            for (auto bb : rpo)
             {
+                if (!dirty[bb->getId()])
+                {
+                    continue;
+                }
+                dirty[bb->getId()] = false;
+
                 //
                 // def_in   = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
                 // def_out |= def_in
                 //
                 if (contextFreeDefAnalyze(bb))
                 {
+                    for (auto succ : bb->Succs)
+                    {
+                        dirty[succ->getId()] = true;
+                    }
                     change = true;
                 }
             }
@@ -1402,6 +1443,171 @@ void LivenessAnalysis::computeLiveness()
     stopTimer(TIMER_LIVENESS);
 }
 
+//
+// Compute for each candidate variable a signature of the instructions and
+// operands referencing it, in program order. Operands are never modified in
+// place, so two equal signatures mean the variable has the same references.
+//
+void LivenessAnalysis::computeRefSignatures(std::vector<uint64_t>& sigs) const
+{
+    sigs.assign(numVarId, 0);
+
+    auto addRef = [&](G4_BB* bb, G4_INST* inst, G4_Operand* opnd, unsigned slot)
+    {
+        G4_Declare* topdcl = opnd ? opnd->getTopDcl() : nullptr;
+        if (!topdcl)
+        {
+            return;
+        }
+        G4_RegVar* var = topdcl->getRegVar();
+        unsigned id = var->getId();
+        if (id >= numVarId || vars[id] != var)
+        {
+            return;
+        }
+        uint64_t ref = std::hash<const void*>()(bb) ^
+            (std::hash<const void*>()(inst) * 31) ^
+            (std::hash<const void*>()(opnd) * 961) ^ slot;
+        sigs[id] = (sigs[id] ^ ref) * 0x100000001b3ULL;
+    };
+
+    for (auto bb : fg)
+    {
+        for (auto inst : *bb)
+        {
+            addRef(bb, inst, inst->getDst(), 0);
+            for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+            {
+                addRef(bb, inst, inst->getSrc(i), i + 1);
+            }
+        }
+    }
+}
+
+//
+// Seed use_out/def_in with the solution of a previous run over the same CFG.
+// Variables are matched by declare since their ids are reassigned on every
+// run. Only variables that are not spilled, not address taken and whose
+// references did not change since the seed was saved keep their sets.
+//
+bool LivenessAnalysis::applySeed(const LivenessSeed& seed)
+{
+    if (seed.bbs.size() != numBBId)
+    {
+        return false;
+    }
+    for (auto bb : fg)
+    {
+        if (seed.bbs[bb->getId()] != bb)
+        {
+            return false;
+        }
+    }
+
+    std::vector<uint64_t> refSigs;
+    computeRefSignatures(refSigs);
+
+    unsigned numOldVars = (unsigned)seed.vars.size();
+    std::vector<unsigned> newId(numOldVars, UNDEFINED_VAL);
+    for (unsigned i = 0; i < numOldVars; i++)
+    {
+        G4_Declare* dcl = seed.vars[i];
+        G4_RegVar* var = dcl->getRegVar();
+        unsigned id = var->getId();
+        if (id < numVarId && vars[id] == var &&
+            !dcl->isSpilled() && !dcl->getAddressed() &&
+            refSigs[id] == seed.refSigs[i])
+        {
+            newId[i] = id;
+        }
+    }
+
+    auto remap = [&](const BitSet& from, BitSet& to)
+    {
+        unsigned numElts = (numOldVars + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+        for (unsigned elt = 0; elt < numElts; elt++)
+        {
+            BITSET_ARRAY_TYPE bits = from.getElt(elt);
+            for (unsigned bit = 0; bits != 0; bit++, bits >>= 1)
+            {
+                unsigned oldId = elt * NUM_BITS_PER_ELT + bit;
+                if ((bits & 1) && oldId < numOldVars && newId[oldId] != UNDEFINED_VAL)
+                {
+                    to.set(newId[oldId], true);
+                }
+            }
+        }
+    };
+
+    for (unsigned i = 0; i < numBBId; i++)
+    {
+        remap(seed.use_out[i], use_out[i]);
+        remap(seed.def_in[i], def_in[i]);
+    }
+    return true;
+}
+
+//
+// Save the solution as a seed for the next run. This must be called before the
+// IR is changed, so that the reference signatures match the solution.
+//
+void LivenessAnalysis::saveSeed(LivenessSeed& seed) const
+{
+    seed.clear();
+    if (numVarId == 0 || performIPA())
+    {
+        // the context sensitive sets cannot seed the context free analysis
+        return;
+    }
+
+    seed.vars.resize(numVarId);
+    for (unsigned i = 0; i < numVarId; i++)
+    {
+        seed.vars[i] = vars[i]->getDeclare();
+    }
+    computeRefSignatures(seed.refSigs);
+    seed.bbs.resize(numBBId);
+    for (auto bb : fg)
+    {
+        seed.bbs[bb->getId()] = bb;
+    }
+    seed.use_out = use_out;
+    seed.def_in = def_in;
+}
+
+//
+// Return true if both analyses, run over the same IR, computed the same sets.
+// Used to check the seeded liveness against a full recompute.
+//
+bool LivenessAnalysis::hasSameSolution(const LivenessAnalysis& other) const
+{
+    if (numVarId != other.numVarId || numBBId != other.numBBId)
+    {
+        return false;
+    }
+    for (unsigned i = 0; i < numVarId; i++)
+    {
+        if (vars[i] != other.vars[i])
+        {
+            return false;
+        }
+    }
+    for (unsigned i = 0; i < numBBId; i++)
+    {
+        for (unsigned j = 0; j < numVarId; j++)
+        {
+            if (use_in[i].isSet(j) != other.use_in[i].isSet(j) ||
+                use_out[i].isSet(j) != other.use_out[i].isSet(j) ||
+                def_in[i].isSet(j) != other.def_in[i].isSet(j) ||
+                def_out[i].isSet(j) != other.def_out[i].isSet(j))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 //
 // compute the maydef set for every subroutine
 // This includes recursively all the variables that are defined by the
@@ -2585,67 +2791,86 @@ bool LivenessAnalysis::contextSensitiveForwardDataAnalyze(
 //
 // use_out = use_in(s1) + use_in(s2) + ... where s1 s2 ... are the successors of bb
 // use_in  = use_gen + (use_out - use_kill)
+// returns true if use_in changed, i.e., the predecessors of bb need to be revisited
 //
 bool LivenessAnalysis::contextFreeUseAnalyze(G4_BB* bb)
 {
-    bool changed;
-
     unsigned bbid = bb->getId();
 
-    if (bb->Succs.empty()) // exit block
+    for (BB_LIST_ITER it = bb->Succs.begin(), end = bb->Succs.end(); it != end; it++)
     {
-        changed = false;
-    }
-
-    else
-    {
-        BitSet old = use_out[bbid];
-        for (BB_LIST_ITER it = bb->Succs.begin(), end = bb->Succs.end(); it != end; it++)
-        {
-            use_out[bbid] |= use_in[(*it)->getId()];
-        }
-
-        changed = (old != use_out[bbid]);
+        use_out[bbid] |= use_in[(*it)->getId()];
     }
 
     //
     // in = gen + (out - kill)
     //
-    use_in[bbid] = use_out[bbid];
-    use_in[bbid] -= use_kill[bbid];
-    use_in[bbid] |= use_gen[bbid];
-
-    return changed;
+    return use_in[bbid].assignGenKill(use_gen[bbid], use_out[bbid], use_kill[bbid]);
 }
 
 //
 // def_in = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
 // def_out |= def_in
+// returns true if def_out changed, i.e., the successors of bb need to be revisited
 //
 bool LivenessAnalysis::contextFreeDefAnalyze(G4_BB* bb)
 {
-    bool changed  = false;
     unsigned bbid = bb->getId();
 
-    if (bb->Preds.empty())
+    for (BB_LIST_ITER it = bb->Preds.begin(), end = bb->Preds.end(); it != end; it++)
     {
-        changed = false;
+        def_in[bbid] |= def_out[(*it)->getId()];
     }
-    else
-    {
-        BitSet old = def_in[bbid];
 
-        for (BB_LIST_ITER it = bb->Preds.begin(), end = bb->Preds.end(); it != end; it++)
+    return def_out[bbid].orWithChange(def_in[bbid]);
+}
+
+//
+// Reverse post-order of the BBs reachable from the entry BB, followed by the
+// unreachable ones in layout order so that every BB is still visited.
+//
+void LivenessAnalysis::computeRPO(std::vector<G4_BB*>& rpo) const
+{
+    rpo.clear();
+    rpo.reserve(numBBId);
+
+    std::vector<bool> visited(numBBId, false);
+    std::vector<std::pair<G4_BB*, BB_LIST_ITER>> stack;
+    std::vector<G4_BB*> postOrder;
+    postOrder.reserve(numBBId);
+
+    G4_BB* entryBB = fg.getEntryBB();
+    visited[entryBB->getId()] = true;
+    stack.push_back(std::make_pair(entryBB, entryBB->Succs.begin()));
+    while (!stack.empty())
+    {
+        G4_BB* bb = stack.back().first;
+        BB_LIST_ITER& it = stack.back().second;
+        if (it != bb->Succs.end())
         {
-            def_in[bbid] |= def_out[(*it)->getId()];
+            G4_BB* succ = *it;
+            ++it;
+            if (!visited[succ->getId()])
+            {
+                visited[succ->getId()] = true;
+                stack.push_back(std::make_pair(succ, succ->Succs.begin()));
+            }
+        }
+        else
+        {
+            postOrder.push_back(bb);
+            stack.pop_back();
         }
-
-        changed = (old != def_in[bbid]);
     }
 
-     def_out[bb->getId()] |= def_in[bb->getId()];
-
-     return changed;
+    rpo.assign(postOrder.rbegin(), postOrder.rend());
+    for (auto bb : fg)
+    {
+        if (!visited[bb->getId()])
+        {
+            rpo.push_back(bb);
+        }
+    }
 }
 
 void LivenessAnalysis::dump_bb_vector(char* vname, std::vector<BitSet>& vec)
@@ -3664,6 +3889,13 @@ static void recordRAStats(IR_Builder& builder,
         default:
             assert(0 && "Incorrect RA type");
         }
+
+        auto jitInfo = builder.getJitInfo();
+        if (jitInfo && jitInfo->spillMemUsed > 0)
+        {
+            Stats.SetI64("SpillMemUsed", jitInfo->spillMemUsed, SimdSize);
+            Stats.SetI64("SpillMemUnshared", jitInfo->spillMemUnshared, SimdSize);
+        }
     }
 #endif // COMPILER_STATS_ENABLE
 }
@@ -391,6 +391,35 @@ struct VarRangeListPackage
     VAR_RANGE_LIST list;
 };
 
+//
+// Liveness solution of one GRF global RA iteration, used to warm start the
+// fixed point of the next iteration after spill code is inserted. It is saved
+// before the spill code goes in, together with a signature of the references
+// to each variable. A variable keeps its seed only if it is not spilled and its
+// references are unchanged: its liveness is then the same as before, so the
+// seeded fixed point converges to the same solution as a full recompute.
+// Variables whose references changed, e.g. by spill cleanup removing a split
+// move, start empty like the new spill and fill temporaries.
+//
+struct LivenessSeed
+{
+    std::vector<G4_Declare*> vars;  // old var id -> declare
+    std::vector<uint64_t> refSigs;  // old var id -> signature of its references
+    std::vector<G4_BB*> bbs;        // bb id -> bb
+    std::vector<BitSet> use_out;
+    std::vector<BitSet> def_in;
+
+    bool empty() const { return vars.empty(); }
+    void clear()
+    {
+        vars.clear();
+        refSigs.clear();
+        bbs.clear();
+        use_out.clear();
+        def_in.clear();
+    }
+};
+
 class LivenessAnalysis
 {
     unsigned numVarId;         // the var count
@@ -430,6 +459,7 @@ class LivenessAnalysis
 
     bool contextFreeUseAnalyze(G4_BB* bb);
     bool contextFreeDefAnalyze(G4_BB* bb);
+    void computeRPO(std::vector<G4_BB*>& rpo) const;
 
     bool livenessCandidate(G4_Declare* decl, bool verifyRA);
 
@@ -441,6 +471,8 @@ class LivenessAnalysis
     void footprintDst(G4_BB* bb, G4_INST* i, G4_Operand* opnd, BitSet* dstfootprint, bool isLocal);
     void footprintSrc(G4_INST* i, G4_Operand *opnd, BitSet* srcfootprint);
     void detectNeverDefinedVarRows();
+    bool applySeed(const LivenessSeed& seed);
+    void computeRefSignatures(std::vector<uint64_t>& sigs) const;
 
 public:
     GlobalRA& gra;
@@ -457,13 +489,15 @@ public:
     std::vector<BitSet> use_out;
     std::vector<BitSet> use_gen;
     std::vector<BitSet> use_kill;
-    std::vector<BitSet> indr_use;
+    std::vector<BitSet> indr_use;   // only populated for RA verification
     std::vector<BitSet> maydef;
 
     LivenessAnalysis(GlobalRA& gra, uint8_t kind);
     LivenessAnalysis(GlobalRA& gra, unsigned char kind, bool verifyRA, bool forceRun = false);
     ~LivenessAnalysis();
-    void computeLiveness();
+    void computeLiveness(const LivenessSeed* seed = nullptr);
+    void saveSeed(LivenessSeed& seed) const;
+    bool hasSameSolution(const LivenessAnalysis& other) const;
     bool isLiveAtEntry(G4_BB* bb, unsigned var_id) const;
     bool isLiveAtExit(G4_BB* bb, unsigned var_id) const;
     bool isAddressSensitive (unsigned num) const  // returns true if the variable is address taken and also has indirect access
@@ -25,6 +25,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
 #include "Rematerialization.h"
+#include <algorithm>
+#include <unordered_set>
 
 namespace vISA
 {
@@ -466,8 +468,13 @@ namespace vISA
         if (!uniqueDef)
             return false;
 
-        // Def has a lot of uses so we will need lots of remat to make this profitable
-        if (refs.numUses > MAX_USES_REMAT)
+        // Def has a lot of uses so we will need lots of remat to make this profitable.
+        // A spilled var needs a fill at each use anyway, so for it we allow more
+        // uses as long as remat costs a single instruction per use (checked below).
+        bool srcDclSpilled = isRangeSpilled(topdcl);
+        if (refs.numUses > MAX_USES_REMAT &&
+            (!srcDclSpilled || refs.numUses > MAX_USES_SPILLED_REMAT ||
+             uniqueDef->first->isSend()))
             return false;
 
         if (uniqueDef->first->getPredicate() ||
@@ -497,14 +504,10 @@ namespace vISA
         if (!inSameSubroutine(bb, uniqueDefBB))
             return false;
 
-#if 0
-        // idom currently not computed
-
         // Def must be in a dominating BB
         auto defDomsUse = doms.dominates(uniqueDefBB, bb);
         if (!defDomsUse)
             return false;
-#endif
 
         // If uniqueDefBB is not under SIMD CF, current BB is under SIMD CF
         // then we can remat only if def has NoMask option set.
@@ -517,7 +520,6 @@ namespace vISA
 
         // Check whether they are in a loop. If yes, they should be in same loop.
         bool uniqueDefOutsideLoop = false;
-        bool srcDclSpilled = isRangeSpilled(topdcl);
         bool inSameLoop = areInSameLoop(uniqueDefBB, bb, uniqueDefOutsideLoop);
         bool onlyUseInLoop = uniqueDefOutsideLoop && !inSameLoop;
         bool doNumRematCheck = false;
@@ -798,6 +800,12 @@ namespace vISA
             }
         }
 
+        // Remat of a spilled var with many uses only pays off when no src
+        // live-range is extended, eg uniform constants and address computations
+        // whose inputs are still live.
+        if (refs.numUses > MAX_USES_REMAT && anySrcNotLive)
+            return false;
+
         // Record remats in loop only for non-scalar operations. This is a heuristic used
         // to not remat excessively in loops.
         if (!inSameLoop &&
@@ -1183,39 +1191,115 @@ namespace vISA
 
     void Dominators::computeDominators()
     {
-        // Compute all doms for given bb.
-        // Flowgraph already has idoms for each bb.
-        for (auto&& bb : fg)
+        // Compute the immediate dominator of each BB with the iterative
+        // algorithm of Cooper, Harvey and Kennedy over reverse post-order
+        // and record it in the flowgraph.  BBs unreachable from the entry
+        // get no idom.
+        std::vector<G4_BB*> rpo;
+        std::unordered_map<G4_BB*, unsigned int> rpoId;
+        {
+            std::vector<std::pair<G4_BB*, BB_LIST_ITER>> stack;
+            std::unordered_set<G4_BB*> visited;
+            auto entryBB = fg.getEntryBB();
+            visited.insert(entryBB);
+            stack.push_back(std::make_pair(entryBB, entryBB->Succs.begin()));
+            while (!stack.empty())
+            {
+                auto& top = stack.back();
+                if (top.second != top.first->Succs.end())
+                {
+                    G4_BB* succ = *top.second++;
+                    if (visited.insert(succ).second)
+                    {
+                        stack.push_back(std::make_pair(succ, succ->Succs.begin()));
+                    }
+                }
+                else
+                {
+                    rpo.push_back(top.first);
+                    stack.pop_back();
+                }
+            }
+            std::reverse(rpo.begin(), rpo.end());
+            for (unsigned int i = 0; i < rpo.size(); i++)
+            {
+                rpoId[rpo[i]] = i;
+            }
+        }
+
+        for (auto bb : fg)
+        {
+            bb->setIDom(nullptr);
+        }
+
+        if (rpo.empty())
+            return;
+
+        const unsigned int undef = UINT_MAX;
+        std::vector<unsigned int> idom(rpo.size(), undef);
+        idom[0] = 0;
+
+        auto intersect = [&idom](unsigned int b1, unsigned int b2)
+        {
+            while (b1 != b2)
+            {
+                while (b1 > b2)
+                    b1 = idom[b1];
+                while (b2 > b1)
+                    b2 = idom[b2];
+            }
+            return b1;
+        };
+
+        bool changed = true;
+        while (changed)
         {
-            std::pair<G4_BB*, std::set<G4_BB*>> domBB;
-            domBB.first = bb;
-            auto idom = bb->getIDom();
-            while (idom)
+            changed = false;
+            for (unsigned int i = 1; i < rpo.size(); i++)
             {
-                domBB.second.insert(bb->getIDom());
-                idom = idom->getIDom();
+                unsigned int newIdom = undef;
+                for (auto pred : rpo[i]->Preds)
+                {
+                    auto it = rpoId.find(pred);
+                    if (it == rpoId.end() || idom[it->second] == undef)
+                        continue;
+                    newIdom = (newIdom == undef) ?
+                        it->second : intersect(it->second, newIdom);
+                }
+                if (newIdom != idom[i])
+                {
+                    idom[i] = newIdom;
+                    changed = true;
+                }
             }
         }
+
+        for (unsigned int i = 1; i < rpo.size(); i++)
+        {
+            if (idom[i] != undef)
+                rpo[i]->setIDom(rpo[idom[i]]);
+        }
     }
+
+    // Return true if every path from the entry to use goes through def.
+    // A BB dominates itself.
     bool Dominators::dominates(G4_BB* def, G4_BB* use)
     {
-        auto dIt = dom.find(use);
-        if (dIt == dom.end())
-            return false;
-
-        auto bbIt = dIt->second.find(def);
-        if (bbIt == dIt->second.end())
-            return false;
+        for (auto bb = use; bb; bb = bb->getIDom())
+        {
+            if (bb == def)
+                return true;
+        }
 
-        return true;
+        return false;
     }
 
     void Dominators::dump()
     {
-        for (auto&& bb : dom)
+        for (auto bb : fg)
         {
-            printf("BB%d:", bb.first->getId());
-            for (auto&& d : bb.second)
+            printf("BB%d:", bb->getId());
+            for (auto d = bb->getIDom(); d; d = d->getIDom())
             {
                 printf("BB%d, ", d->getId());
             }
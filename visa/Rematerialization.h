@@ -38,6 +38,10 @@ namespace vISA
 // Remat will trigger only for vars that have less than following uses
 #define MAX_USES_REMAT 6
 
+// Upper bound on uses of a spilled var whose def can be remat'd without
+// extending any live-range
+#define MAX_USES_SPILLED_REMAT 16
+
 // Minimum def-use distance for remat to trigger
 #define MIN_DEF_USE_DISTANCE 20
 
@@ -73,8 +77,6 @@ namespace vISA
     class Dominators
     {
     private:
-        std::map<G4_BB*, std::set<G4_BB*>> dom;
-
         FlowGraph& fg;
 
     public:
@@ -83,8 +85,8 @@ namespace vISA
             computeDominators();
         }
 
-        // Store dominator information in data structure above for easy querying.
-        // Flow graph stores immediate doms of each BB.s
+        // Compute the immediate dominator of each BB and store it in the
+        // flowgraph (G4_BB::getIDom()); dominates() walks that chain.
         void computeDominators();
         bool dominates(G4_BB*, G4_BB*);
         void dump();
@@ -27,7 +27,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "FlowGraph.h"
 #include "GraphColor.h"
 #include "SpillManagerGMRF.h"
+#include "Rematerialization.h"
 #include <list>
+#include <unordered_map>
 #include "SpillCleanup.h"
 
 uint32_t computeFillMsgDesc(unsigned int payloadSize, unsigned int offset);
@@ -75,7 +77,7 @@ G4_SrcRegRegion* CoalesceSpillFills::generateCoalescedSpill(unsigned int scratch
 }
 
 G4_DstRegRegion* CoalesceSpillFills::generateCoalescedFill(unsigned int scratchOffset, unsigned int payloadSize,
-    unsigned int dclSize, G4_SendMsgDescriptor* sample, int srcCISAOff, bool evenAlignDst)
+    unsigned int dclSize, G4_SendMsgDescriptor* sample, int srcCISAOff, bool evenAlignDst, bool spillable)
 {
     // Generate split send instruction with specified payload size and offset
     // Construct fillDst
@@ -89,7 +91,10 @@ G4_DstRegRegion* CoalesceSpillFills::generateCoalescedFill(unsigned int scratchO
         fillDcl->setEvenAlign();
         gra.setEvenAligned(fillDcl, true);
     }
-    fillDcl->setDoNotSpill();
+    if (!spillable)
+    {
+        fillDcl->setDoNotSpill();
+    }
 
     auto fillDst = kernel.fg.builder->createDstRegRegion(Direct, fillDcl->getRegVar(), 0,
         0, 1, Type_UW);
@@ -275,8 +280,23 @@ void CoalesceSpillFills::coalesceFills(std::list<INST_LIST_ITER>& coalesceableFi
 
     auto leadInst = *coalesceableFills.front();
 
+    bool hoisted = false;
+    for (auto c : coalesceableFills)
+    {
+        if (hoistedFillDcl.find((*c)->getDst()->getTopDcl()) != hoistedFillDcl.end())
+        {
+            hoisted = true;
+            break;
+        }
+    }
+
     auto coalescedFillDst = generateCoalescedFill(min, payloadSize, dclSize,
-        leadInst->getMsgDesc(), srcCISAOff, gra.isEvenAligned(leadInst->getDst()->getTopDcl()));
+        leadInst->getMsgDesc(), srcCISAOff, gra.isEvenAligned(leadInst->getDst()->getTopDcl()),
+        hoisted);
+    if (hoisted)
+    {
+        hoistedFillDcl.insert(coalescedFillDst->getTopDcl());
+    }
 
     for (auto c : coalesceableFills)
     {
@@ -1092,8 +1112,12 @@ void CoalesceSpillFills::fills()
 
             instIter++;
         }
+    }
 
-        // One pass to replace old fills with coalesced dcl
+    // One pass to replace old fills with coalesced dcl. Fills hoisted out
+    // of loops are used in other BBs so this covers the whole kernel.
+    for (auto bb : kernel.fg)
+    {
         for (auto instIt = bb->begin();
             instIt != bb->end();
             )
@@ -1113,6 +1137,257 @@ void CoalesceSpillFills::fills()
     }
 }
 
+void CoalesceSpillFills::hoistLoopInvariantFills()
+{
+    // Move fills of scratch slots that are not written inside a loop to
+    // the loop's preheader, so the slot is read once instead of once per
+    // iteration:
+    //
+    // BB1:                               BB1:
+    //   ...                                ...
+    //                                      fill GLOB_FILL <- offset = 4
+    // BB2: (loop header)                 BB2:
+    //   ...                         ===>   ...
+    //   fill FL_V10 <- offset = 4
+    //   add ... FL_V10 ...                 add ... GLOB_FILL ...
+    //   (f0) jmpi BB2                      (f0) jmpi BB2
+    //
+    // The fill's value now lives across the whole loop, so only loops
+    // with low enough register pressure are considered. Fill temps are
+    // not spillable; the hoisted value is given a new, spillable declare
+    // so that the next RA iteration can still spill it if needed.
+    // Fills left next to each other in the preheader are coalesced into
+    // wider reads by fills().
+    if (kernel.fg.naturalLoops.empty() ||
+        kernel.fg.getHasStackCalls() ||
+        kernel.fg.getIsStackCallFunc())
+    {
+        return;
+    }
+
+    // A fill is hoisted only when it is the sole def of its destination.
+    std::unordered_map<G4_Declare*, unsigned int> numDefs;
+    for (auto bb : kernel.fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isPseudoKill())
+                continue;
+            auto dst = inst->getDst();
+            if (dst && dst->getTopDcl())
+                numDefs[dst->getTopDcl()]++;
+        }
+    }
+
+    Dominators doms(kernel.fg);
+
+    // Visit inner loops before outer ones so fills can move out of a loop
+    // nest one level at a time. Order is made deterministic by BB ids.
+    std::vector<std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>> loops;
+    for (auto& loop : kernel.fg.naturalLoops)
+    {
+        loops.push_back(std::make_pair(loop.first, &loop.second));
+    }
+    std::sort(loops.begin(), loops.end(),
+        [](const std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>& l1,
+           const std::pair<FlowGraph::Edge, const FlowGraph::Blocks*>& l2)
+    {
+        if (l1.second->size() != l2.second->size())
+            return l1.second->size() < l2.second->size();
+        if (l1.first.second->getId() != l2.first.second->getId())
+            return l1.first.second->getId() < l2.first.second->getId();
+        return l1.first.first->getId() < l2.first.first->getId();
+    });
+
+    // GRFs of hoisted fills live through each BB
+    std::unordered_map<G4_BB*, unsigned int> hoistedPressure;
+    auto builtinR0 = kernel.fg.builder->getBuiltinR0();
+
+    for (auto& loop : loops)
+    {
+        G4_BB* latch = loop.first.first;
+        G4_BB* header = loop.first.second;
+        const FlowGraph::Blocks& blocks = *loop.second;
+
+        // Need a unique preheader that falls into the header only
+        G4_BB* preheader = nullptr;
+        bool hasUniquePreheader = true;
+        for (auto pred : header->Preds)
+        {
+            if (blocks.find(pred) != blocks.end())
+                continue;
+            if (preheader)
+                hasUniquePreheader = false;
+            preheader = pred;
+        }
+        if (!preheader || !hasUniquePreheader ||
+            preheader->Succs.size() != 1 ||
+            (preheader->getBBType() & G4_BB_CALL_TYPE) ||
+            (header->getBBType() & G4_BB_INIT_TYPE))
+        {
+            continue;
+        }
+
+        // Collect scratch rows written in the loop and its peak pressure.
+        // Bail on calls since a callee's spills are not part of the loop
+        // body.
+        std::set<unsigned int> writtenRows;
+        unsigned int maxPressure = 0;
+        bool hasCall = false;
+        for (auto bb : blocks)
+        {
+            if (bb->getBBType() & (G4_BB_CALL_TYPE | G4_BB_RETURN_TYPE))
+            {
+                hasCall = true;
+                break;
+            }
+
+            unsigned int extra = hoistedPressure[bb];
+            for (auto inst : *bb)
+            {
+                if (inst->isCall() || inst->isFCall() ||
+                    inst->isReturn() || inst->isFReturn())
+                {
+                    hasCall = true;
+                    break;
+                }
+
+                maxPressure = std::max(maxPressure,
+                    rpe.getRegisterPressure(inst) + extra);
+
+                if (inst->isSend() &&
+                    inst->getMsgDesc()->isScratchWrite())
+                {
+                    unsigned int offset, size;
+                    getScratchMsgInfo(inst, offset, size);
+                    for (unsigned int row = offset; row != offset + size; row++)
+                        writtenRows.insert(row);
+                }
+            }
+
+            if (hasCall)
+                break;
+        }
+        if (hasCall)
+        {
+            continue;
+        }
+
+        auto insertIt = preheader->end();
+        if (!preheader->empty() &&
+            preheader->back()->isFlowControl())
+        {
+            insertIt--;
+        }
+
+        unsigned int hoistedRows = 0;
+        for (auto bb : kernel.fg)
+        {
+            if (blocks.find(bb) == blocks.end())
+                continue;
+
+            // Only fills that run on every iteration are worth hoisting
+            if (!doms.dominates(bb, latch))
+                continue;
+
+            for (auto instIt = bb->begin(); instIt != bb->end();)
+            {
+                auto inst = (*instIt);
+                auto nextIt = instIt;
+                nextIt++;
+
+                if (!inst->isSend() ||
+                    !inst->getMsgDesc()->isScratchRead() ||
+                    !inst->isWriteEnableInst() ||
+                    inst->getSrc(0)->getTopDcl() != builtinR0)
+                {
+                    instIt = nextIt;
+                    continue;
+                }
+
+                auto fillDcl = inst->getDst()->getTopDcl();
+                unsigned int offset, size;
+                getScratchMsgInfo(inst, offset, size);
+
+                bool canHoist =
+                    fillDcl &&
+                    fillDcl->getRegVar()->isRegVarTransient() &&
+                    numDefs[fillDcl] == 1 &&
+                    addrTakenSpillFillDcl.find(fillDcl) == addrTakenSpillFillDcl.end() &&
+                    maxPressure + hoistedRows + size <= fillHoistThreshold;
+
+                for (unsigned int row = offset; canHoist && row != offset + size; row++)
+                {
+                    canHoist = writtenRows.find(row) == writtenRows.end();
+                }
+
+                if (canHoist)
+                {
+                    // operands are switched over at the end, so a fill that
+                    // already left an inner loop still writes its old temp
+                    if (replaceMap.find(fillDcl) == replaceMap.end())
+                    {
+                        const char* dclName = kernel.fg.builder->getNameString(kernel.fg.mem, 32,
+                            "GLOB_FILL_%d", kernel.Declares.size());
+                        auto hoistedDcl = kernel.fg.builder->createDeclareNoLookup(dclName, G4_GRF,
+                            fillDcl->getNumElems(), fillDcl->getNumRows(), fillDcl->getElemType());
+                        hoistedDcl->setSubRegAlign(GRFALIGN);
+                        gra.setSubRegAlign(hoistedDcl, GRFALIGN);
+                        if (gra.isEvenAligned(fillDcl))
+                        {
+                            hoistedDcl->setEvenAlign();
+                            gra.setEvenAligned(hoistedDcl, true);
+                        }
+                        hoistedFillDcl.insert(hoistedDcl);
+                        replaceMap.insert(std::make_pair(fillDcl, std::make_pair(hoistedDcl, 0u)));
+                    }
+
+                    bb->erase(instIt);
+                    preheader->insert(insertIt, inst);
+                    hoistedRows += size;
+                }
+
+                instIt = nextIt;
+            }
+        }
+
+        if (hoistedRows > 0)
+        {
+            for (auto bb : blocks)
+            {
+                hoistedPressure[bb] += hoistedRows;
+            }
+        }
+    }
+
+    if (replaceMap.empty())
+    {
+        return;
+    }
+
+    // Switch the fills and their uses over to the hoisted declares and
+    // drop the old temps' pseudo kills that would end the live range
+    // inside the loop.
+    for (auto bb : kernel.fg)
+    {
+        for (auto instIt = bb->begin(); instIt != bb->end();)
+        {
+            auto inst = (*instIt);
+
+            if (inst->isPseudoKill() &&
+                replaceMap.find(inst->getDst()->getTopDcl()) != replaceMap.end())
+            {
+                instIt = bb->erase(instIt);
+                continue;
+            }
+
+            replaceCoalescedOperands(inst);
+            instIt++;
+        }
+    }
+    replaceMap.clear();
+}
+
 void CoalesceSpillFills::populateSendDstDcl()
 {
     // Find and store all G4_Declares that are dest in sends
@@ -2014,6 +2289,11 @@ void CoalesceSpillFills::run()
 {
     removeRedundantSplitMovs();
 
+    if (!kernel.getOption(vISA_DisableFillHoisting))
+    {
+        hoistLoopInvariantFills();
+    }
+
     fills();
     replaceMap.clear();
     spills();
@@ -54,9 +54,17 @@ namespace vISA
         const unsigned int cSpillFillCleanupWindowSize = 10;
         const unsigned int cFillWindowThreshold128GRF = 180;
         const unsigned int cSpillWindowThreshold128GRF = 120;
+        // Loop pressure (including fills already hoisted) below which a
+        // loop invariant fill may be moved to the loop preheader
+        const unsigned int cFillHoistThreshold128GRF = 96;
 
         unsigned int fillWindowSizeThreshold = 0;
         unsigned int spillWindowSizeThreshold = 0;
+        unsigned int fillHoistThreshold = 0;
+
+        // Destinations of fills hoisted out of loops. These are live across
+        // the loop so they, and fills coalesced with them, stay spillable.
+        std::set<G4_Declare*> hoistedFillDcl;
 
         // <Old fill declare*, std::pair<Coalesced Decl*, Row Off>>
         // This data structure is used to replaced old spill/fill operands
@@ -75,13 +83,14 @@ namespace vISA
             std::list<INST_LIST_ITER>&,
             unsigned int, unsigned int&, unsigned int&, bool&,
             G4_InstOption&);
+        void hoistLoopInvariantFills();
         void fills();
         void spills();
         INST_LIST_ITER analyzeFillCoalescing(std::list<INST_LIST_ITER>&, INST_LIST_ITER, INST_LIST_ITER, G4_BB*);
         INST_LIST_ITER analyzeSpillCoalescing(std::list<INST_LIST_ITER>&, INST_LIST_ITER, INST_LIST_ITER, G4_BB*);
         void removeWARFills(std::list<INST_LIST_ITER>&, std::list<INST_LIST_ITER>&);
         void coalesceFills(std::list<INST_LIST_ITER>&, unsigned int, unsigned int, G4_BB*, int);
-        G4_DstRegRegion* generateCoalescedFill(unsigned int, unsigned int, unsigned int, G4_SendMsgDescriptor*, int, bool);
+        G4_DstRegRegion* generateCoalescedFill(unsigned int, unsigned int, unsigned int, G4_SendMsgDescriptor*, int, bool, bool);
         G4_SrcRegRegion* generateCoalescedSpill(unsigned int, unsigned int, G4_SendMsgDescriptor*, bool,
             G4_InstOption, int, G4_Declare*, unsigned int);
         void copyToOldFills(G4_DstRegRegion*, std::list<std::pair<G4_DstRegRegion*, std::pair<unsigned int, unsigned int>>>,
@@ -113,6 +122,7 @@ namespace vISA
             };
             fillWindowSizeThreshold = scale(cFillWindowThreshold128GRF);
             spillWindowSizeThreshold = scale(cSpillWindowThreshold128GRF);
+            fillHoistThreshold = scale(cFillHoistThreshold128GRF);
 
             iterationNo = iterNo;
 
@@ -162,6 +162,7 @@ SpillManagerGMRF::SpillManagerGMRF(
     , numGRFFill(0)
     , numGRFMove(0)
     , gra(g)
+    , unsharedSpillSize_(0)
 {
     const unsigned size = sizeof(unsigned) * varIdCount;
     spillRangeCount_ = (unsigned*)allocMem(size);
@@ -574,6 +575,37 @@ SpillManagerGMRF::calculateSpillDisp (
     return regVarLocDisp;
 }
 
+// Assign spill slots to all of this iteration's spilled live ranges up
+// front, largest first.  Left to getDisp() the ranges would be placed in
+// the order their first reference is met, which lets small ranges split
+// the free space that a later large range needs and so grows the area.
+
+void
+SpillManagerGMRF::assignSpillSlots ()
+{
+    std::vector<G4_RegVar *> vars;
+    for (auto lr : spilledLRs_)
+    {
+        G4_RegVar * var = lr->getVar ();
+        if (var->isSpilled () && !var->isRegVarTransient () &&
+            !var->isAliased () && var->getDisp () == UINT_MAX)
+        {
+            vars.push_back (var);
+        }
+    }
+
+    std::stable_sort (vars.begin (), vars.end (),
+        [this](G4_RegVar * v1, G4_RegVar * v2)
+        {
+            return getByteSize (v1) > getByteSize (v2);
+        });
+
+    for (auto var : vars)
+    {
+        var->setDisp (calculateSpillDisp (var));
+    }
+}
+
 // Get the spill/fill displacement of the segment containing the region.
 // A segment is the smallest dword or oword aligned portion of memory
 // containing the destination or source operand that can be read or saved.
@@ -3885,6 +3917,11 @@ SpillManagerGMRF::insertSpillFillCode (
         }
     }
 
+    if (doSpillSpaceCompression)
+    {
+        assignSpillSlots();
+    }
+
     // Handle address taken spills
     bool success = handleAddrTakenSpills( kernel, pointsToAnalysis );
 
@@ -3998,13 +4035,21 @@ SpillManagerGMRF::insertSpillFillCode (
 
     for (auto spill : spilledLRs_)
     {
-        unsigned disp = spill->getVar ()->getDisp ();
+        G4_RegVar * var = spill->getVar ();
+        unsigned disp = var->getDisp ();
 
-        if (spill->getVar ()->isSpilled ())
+        if (var->isSpilled ())
         {
             if (disp != UINT_MAX)
             {
-                nextSpillOffset_ = std::max(nextSpillOffset_, disp + getByteSize(spill->getVar()));
+                nextSpillOffset_ = std::max(nextSpillOffset_, disp + getByteSize(var));
+                // aliased and transient ranges live inside the slot of their
+                // base range, so only the ranges that own a slot are counted
+                if (!var->isAliased () && !var->isRegVarTransient ())
+                {
+                    unsigned slotAlign = useScratchMsg_ ? G4_GRF_REG_NBYTES : OWORD_BYTE_SIZE;
+                    unsharedSpillSize_ += ROUND(getByteSize(var), slotAlign);
+                }
             }
         }
     }
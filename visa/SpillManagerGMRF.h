@@ -112,6 +112,10 @@ public:
     // private variables placed by IGC (marked by spill_mem_offset)
     // this should only be called after insertSpillFillCode()
     uint32_t getNextOffset() const { return nextSpillOffset_; }
+    // return the spill memory this iteration's ranges would take if each had
+    // its own slot (i.e. without spill space compression), on top of the
+    // spill area they were given
+    uint32_t getUnsharedSpillSize() const { return unsharedSpillSize_; }
     // return the cumulative scratch space offset for the next spilled variable. 
     // This adjusts for scratch space reserved for file scope vars and IGC/GT-pin
     uint32_t getNextScratchOffset() const 
@@ -317,6 +321,9 @@ private:
         G4_RegVar * lRange
     ) const;
 
+    void
+    assignSpillSlots ();
+
     template <class REGION_TYPE>
     unsigned
     getMsgType (
@@ -848,6 +855,9 @@ private:
     // The number of mov.
     unsigned numGRFMove;
 
+    // The spill memory needed by this iteration without slot sharing.
+    unsigned unsharedSpillSize_;
+
     // CISA instruction id of current instruction
     G4_INST* curInst;
 
@@ -282,3 +282,55 @@ void dumpAllTimers(const char *asmFileName, bool outputTime)
     }
     timerFile.close();
 }
+
+// Appends one JSON object (one line) per compilation to jsonFileName:
+// {"kernel":"<asm name>","binary_size":N,"peak_arena_bytes":N,"timers_us":{"Total":T,...}}
+// The per-line format lets a benchmark driver accumulate the records of many
+// compilations into a single file.
+void dumpAllTimersJSON(const char *jsonFileName, const char *asmFileName,
+    unsigned binarySize, size_t peakArenaBytes)
+{
+    auto printString = [](std::ostream& os, const char* str)
+    {
+        // drop the indentation used by the text dump
+        while (str && (*str == '\t' || *str == ' '))
+        {
+            ++str;
+        }
+        os << '"';
+        for (; str && *str; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+            {
+                os << '\\';
+            }
+            os << *str;
+        }
+        os << '"';
+    };
+
+    std::ofstream jsonFile;
+    jsonFile.open(jsonFileName, ios_base::app);
+    if (!jsonFile)
+    {
+        std::cerr << "Cannot open " << jsonFileName << " for timer output\n";
+        return;
+    }
+
+    jsonFile << "{\"kernel\":";
+    printString(jsonFile, asmFileName);
+    jsonFile << ",\"binary_size\":" << binarySize;
+    jsonFile << ",\"peak_arena_bytes\":" << peakArenaBytes;
+    jsonFile << ",\"timers_us\":{";
+    for (unsigned i = 0, e = getTotalTimers(); i < e; i++)
+    {
+        if (i != 0)
+        {
+            jsonFile << ",";
+        }
+        printString(jsonFile, timerNames[i]);
+        jsonFile << ":" << std::fixed << std::setprecision(1) << getTimerUS(i);
+    }
+    jsonFile << "}}\n";
+    jsonFile.close();
+}
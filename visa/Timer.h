@@ -44,7 +44,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 // startTimer/stopTimer can be called multiple times
 //
-// To read time, either invoke dumpAllTimers()
+// To read time, either invoke dumpAllTimers() (or dumpAllTimersJSON())
 // or invoke other extern functions in Timer.cpp
 // to get individual timer name, ticks, time count.
 //
@@ -54,6 +54,8 @@ void startTimer(int timer);
 void stopTimer(int timer);
 void setKernelName(const char *name);
 void dumpAllTimers(const char *asmFileName, bool outputTime = false);
+void dumpAllTimersJSON(const char *jsonFileName, const char *asmFileName,
+    unsigned binarySize, size_t peakArenaBytes);
 void dumpEncoderStats(Options *opt, std::string &asmName);
 void resetPerKernel();
 double getTimerUS(unsigned idx);
@@ -8573,7 +8573,6 @@ static void setUniformSampler(G4_InstSend* sendInst, bool uniformSampler)
 Need to split sample_d and sample_dc in to two simd8 sends since HW doesn't support it.
 Also need to split any sample instruciton that has more then 5 parameters. Since there is a limit on msg length.
 */
-static unsigned TmpSmplDstID = 0;
 const char* getNameString(Mem_Manager& mem, size_t size, const char* format, ...)
     {
 #ifdef _DEBUG
@@ -8645,7 +8644,7 @@ int IR_Builder::splitSampleInst(VISASampler3DSubOpCode actualop,
             ++tmpDstRows;
         }
 
-        const char *name = getNameString(mem, 20, "%s%d", "TmpSmplDst_", TmpSmplDstID++);
+        const char *name = getNameString(mem, 20, "%s%d", "TmpSmplDst_", numTmpSmplDst++);
 
         tempDstDcl = createDeclareNoLookup(name,
             originalDstDcl->getRegFile(),
@@ -8747,7 +8746,7 @@ int IR_Builder::splitSampleInst(VISASampler3DSubOpCode actualop,
     G4_Declare* tempDstDcl2 = nullptr;
     if(!dst->isNullReg())
     {
-        const char *name = getNameString(mem, 20, "%s%d", "TmpSmplDst2_", TmpSmplDstID++);
+        const char *name = getNameString(mem, 20, "%s%d", "TmpSmplDst2_", numTmpSmplDst++);
 
         tempDstDcl2 = createDeclareNoLookup(name,
             originalDstDcl->getRegFile(),
@@ -218,6 +218,8 @@ public:
     unsigned long getCodeOffset(){ return m_cisa_kernel.entry; }
 
     CISA_GEN_VAR * getDeclFromName(const std::string &name);
+    CISA_GEN_VAR * getDeclFromDefaultName(const std::string &name);
+    void setResolveDefaultNames(bool val) { m_resolveDefaultNames = val; }
     bool setNameIndexMap(const std::string &name, CISA_GEN_VAR *, bool unique = false);
     void pushIndexMapScopeLevel();
     void popIndexMapScopeLevel();
@@ -971,6 +973,9 @@ private:
     typedef std::map<std::string, CISA_GEN_VAR *> GenDeclNameToVarMap;
     std::vector<GenDeclNameToVarMap> m_GenNamedVarMap;
     GenDeclNameToVarMap m_UniqueNamedVarMap;
+    // When set, names not in the maps above are resolved as the default
+    // names given by getVarName(), e.g., V32 or P3.
+    bool m_resolveDefaultNames = false;
 
     std::map<std::string, VISA_LabelOpnd *> m_label_name_to_index_map;
     std::map<std::string, VISA_LabelOpnd *> m_funcName_to_labelID_map;
@@ -7765,6 +7765,69 @@ CISA_GEN_VAR * VISAKernelImpl::getDeclFromName(const std::string &name)
             return it->second;
         }
     }
+
+    if (m_resolveDefaultNames)
+    {
+        return getDeclFromDefaultName(name);
+    }
+    return NULL;
+}
+
+// Returns the variable that getVarName() names NAME. Kernels not built by
+// the parser have no name maps, but inline asm refers to their variables
+// this way. The variable lists are only kept when the vISA path is enabled.
+CISA_GEN_VAR * VISAKernelImpl::getDeclFromDefaultName(const std::string &name)
+{
+    if (name.size() < 2 || !isdigit(name[1]))
+    {
+        return NULL;
+    }
+    char *end = NULL;
+    unsigned long id = strtoul(name.c_str() + 1, &end, 10);
+    if (*end != '\0')
+    {
+        return NULL;
+    }
+
+    std::vector<CISA_GEN_VAR *> *vars = NULL;
+    switch (name[0])
+    {
+    case 'V':
+        vars = &m_var_info_list;
+        break;
+    case 'P':
+        if (id < COMMON_ISA_NUM_PREDEFINED_PRED)
+        {
+            return NULL;
+        }
+        id -= COMMON_ISA_NUM_PREDEFINED_PRED;
+        vars = &m_pred_info_list;
+        break;
+    case 'A':
+        vars = &m_addr_info_list;
+        break;
+    case 'T':
+        vars = &m_surface_info_list;
+        break;
+    case 'S':
+        vars = &m_sampler_info_list;
+        break;
+    default:
+        return NULL;
+    }
+
+    // Variables are usually listed in index order.
+    if (id < vars->size() && (*vars)[id]->index == id)
+    {
+        return (*vars)[id];
+    }
+    for (CISA_GEN_VAR *decl : *vars)
+    {
+        if (decl->index == id)
+        {
+            return decl;
+        }
+    }
     return NULL;
 }
 
@@ -0,0 +1,137 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Micro-benchmark for the INST_LIST node allocator.
+//
+// Replays the insert/erase pattern of the passes that rewrite instruction
+// lists in place (HW conformity and spill/fill expansion: an instruction is
+// replaced by a short sequence, and some of the new instructions are later
+// removed again) on many basic-block sized lists, once with the plain arena
+// allocator INST_LIST used to have and once with the recycling allocator it
+// uses now.  Each allocator runs in its own process so the peak RSS is its
+// own.  Build and run from visa/:
+//
+//   g++ -O2 -std=c++14 -I. -Iinclude -I../inc -I../inc/common \
+//       benchmark/inst_list_alloc_bench.cpp Arena.cpp Mem_Manager.cpp \
+//       -o inst_list_alloc_bench
+//   ./inst_list_alloc_bench arena
+//   ./inst_list_alloc_bench recycling
+
+#include "Gen4_IR.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sys/resource.h>
+
+using namespace vISA;
+
+static const int NUM_BBS = 2000;
+static const int INSTS_PER_BB = 64;
+static const int NUM_ROUNDS = 50;
+
+template <class Alloc>
+static size_t runLists()
+{
+    typedef std::list<G4_INST*, Alloc> List;
+    Alloc alloc;
+    std::vector<List> bbs;
+    bbs.reserve(NUM_BBS);
+    uintptr_t next = 1;
+    for (int i = 0; i < NUM_BBS; i++)
+    {
+        bbs.emplace_back(alloc);
+        for (int j = 0; j < INSTS_PER_BB; j++)
+        {
+            bbs.back().push_back((G4_INST*)(next++ * 8));
+        }
+    }
+
+    size_t checksum = 0;
+    for (int round = 0; round < NUM_ROUNDS; round++)
+    {
+        for (auto& insts : bbs)
+        {
+            // expand every other instruction into three
+            int ix = 0;
+            for (auto it = insts.begin(); it != insts.end(); ++ix)
+            {
+                if (ix % 2 == 0)
+                {
+                    insts.insert(it, (G4_INST*)(next++ * 8));
+                    insts.insert(it, (G4_INST*)(next++ * 8));
+                    it = insts.erase(it);
+                    insts.insert(it, (G4_INST*)(next++ * 8));
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            // clean up back to the original length
+            auto it = insts.begin();
+            while (insts.size() > INSTS_PER_BB)
+            {
+                it = insts.erase(it);
+                ++it;
+                if (it == insts.end())
+                {
+                    it = insts.begin();
+                }
+            }
+            for (G4_INST* inst : insts)
+            {
+                checksum += (uintptr_t)inst;
+            }
+        }
+    }
+    return checksum;
+}
+
+int main(int argc, const char** argv)
+{
+    bool recycling = argc > 1 && strcmp(argv[1], "recycling") == 0;
+    if (argc != 2 || (!recycling && strcmp(argv[1], "arena") != 0))
+    {
+        fprintf(stderr, "usage: %s arena|recycling\n", argv[0]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t checksum = recycling ?
+        runLists<std_arena_recycling_allocator<G4_INST*>>() :
+        runLists<std_arena_based_allocator<G4_INST*>>();
+    auto end = std::chrono::steady_clock::now();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%-10s time %8.1f ms  peak RSS %8ld KB  (checksum %zx)\n",
+        argv[1],
+        std::chrono::duration<double, std::milli>(end - start).count(),
+        (long)usage.ru_maxrss,
+        checksum);
+    return 0;
+}
@@ -0,0 +1,210 @@
+#!/usr/bin/env python
+
+#===================== begin_copyright_notice ==================================
+
+#Copyright (c) 2017 Intel Corporation
+
+#Permission is hereby granted, free of charge, to any person obtaining a
+#copy of this software and associated documentation files (the
+#"Software"), to deal in the Software without restriction, including
+#without limitation the rights to use, copy, modify, merge, publish,
+#distribute, sublicense, and/or sell copies of the Software, and to
+#permit persons to whom the Software is furnished to do so, subject to
+#the following conditions:
+
+#The above copyright notice and this permission notice shall be included
+#in all copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+#MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+#IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+#CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+#TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+#SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#======================= end_copyright_notice ==================================
+
+"""
+Compile-time benchmark for the vISA finalizer.
+
+'run' compiles every .visaasm/.isa file of a corpus with the standalone driver
+(GenX_IR), using -timestatsJSON to collect the per-phase timers of Timer.def,
+the peak arena memory and the size of the generated binary. Each kernel is
+compiled several times and the median of every metric is kept, so a single
+noisy run does not show up as a regression.
+
+'compare' checks a result file against a baseline and exits with a non-zero
+status if any kernel got slower, bigger or more memory hungry than the given
+thresholds allow.
+
+Example:
+  visa_compile_bench.py run --driver GenX_IR --platform SKL \\
+      --corpus corpus --output current.json
+  visa_compile_bench.py compare --baseline baseline.json --current current.json
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    if len(values) % 2:
+        return values[mid]
+    return (values[mid - 1] + values[mid]) / 2.0
+
+
+def find_kernels(corpus):
+    kernels = []
+    for root, _, files in os.walk(corpus):
+        for name in files:
+            if name.endswith((".visaasm", ".isaasm", ".isa")):
+                kernels.append(os.path.join(root, name))
+    return sorted(kernels)
+
+
+def compile_once(driver, kernel, platform, extra_args, work_dir):
+    stats_file = os.path.join(work_dir, "stats.jsonl")
+    if os.path.exists(stats_file):
+        os.remove(stats_file)
+
+    cmd = [driver, os.path.abspath(kernel), "-platform", platform,
+           "-timestatsJSON", stats_file] + extra_args
+    with open(os.devnull, "w") as devnull:
+        status = subprocess.call(cmd, cwd=work_dir, stdout=devnull, stderr=devnull)
+    if status != 0:
+        raise RuntimeError("'%s' failed with exit code %d" % (" ".join(cmd), status))
+
+    with open(stats_file) as f:
+        records = [json.loads(line) for line in f if line.strip()]
+    if not records:
+        raise RuntimeError("no statistics were written for %s" % kernel)
+    return records[-1]
+
+
+def run(args):
+    kernels = find_kernels(args.corpus)
+    if not kernels:
+        print("no kernels found in %s" % args.corpus, file=sys.stderr)
+        return 1
+
+    results = {"platform": args.platform, "iterations": args.iterations, "kernels": {}}
+    work_dir = tempfile.mkdtemp(prefix="visa_bench_")
+    try:
+        for kernel in kernels:
+            name = os.path.relpath(kernel, args.corpus)
+            runs = [compile_once(args.driver, kernel, args.platform, args.extra_args, work_dir)
+                    for _ in range(args.iterations)]
+
+            timers = {}
+            for timer in runs[0]["timers_us"]:
+                timers[timer] = median([r["timers_us"][timer] for r in runs])
+            results["kernels"][name] = {
+                "timers_us": timers,
+                "peak_arena_bytes": median([r["peak_arena_bytes"] for r in runs]),
+                "binary_size": median([r["binary_size"] for r in runs]),
+            }
+            print("%-40s total %10.1f us  peak %8d KB  binary %7d B" % (
+                name, timers.get("Total", 0.0),
+                results["kernels"][name]["peak_arena_bytes"] // 1024,
+                results["kernels"][name]["binary_size"]))
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+    with open(args.output, "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    return 0
+
+
+def relative_change(base, cur):
+    if base == 0:
+        return 0.0 if cur == 0 else float("inf")
+    return (cur - base) / float(base)
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.current) as f:
+        current = json.load(f)
+
+    regressions = []
+    for name, base in sorted(baseline["kernels"].items()):
+        cur = current["kernels"].get(name)
+        if cur is None:
+            regressions.append("%s: missing from the current results" % name)
+            continue
+
+        # phases below the noise floor are too short to compare reliably
+        for timer, base_us in sorted(base["timers_us"].items()):
+            cur_us = cur["timers_us"].get(timer, 0.0)
+            if max(base_us, cur_us) < args.min_time_us:
+                continue
+            change = relative_change(base_us, cur_us)
+            if change > args.time_threshold:
+                regressions.append("%s: %s %.1f us -> %.1f us (%+.1f%%)" % (
+                    name, timer, base_us, cur_us, change * 100))
+
+        for metric, threshold in (("peak_arena_bytes", args.mem_threshold),
+                                  ("binary_size", args.size_threshold)):
+            change = relative_change(base[metric], cur[metric])
+            if change > threshold:
+                regressions.append("%s: %s %d -> %d (%+.1f%%)" % (
+                    name, metric, base[metric], cur[metric], change * 100))
+
+    for line in regressions:
+        print("REGRESSION " + line)
+    if not regressions:
+        print("no regressions in %d kernels" % len(baseline["kernels"]))
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="vISA compile-time benchmark")
+    sub = parser.add_subparsers(dest="command")
+
+    run_parser = sub.add_parser("run", help="compile a corpus and record statistics")
+    run_parser.add_argument("--driver", required=True, help="path to the GenX_IR driver")
+    run_parser.add_argument("--corpus", required=True, help="directory with .visaasm/.isa kernels")
+    run_parser.add_argument("--platform", default="SKL", help="target platform (default: SKL)")
+    run_parser.add_argument("--iterations", type=int, default=5,
+                            help="compiles per kernel; the median is recorded (default: 5)")
+    run_parser.add_argument("--output", required=True, help="result JSON file")
+    run_parser.add_argument("extra_args", nargs=argparse.REMAINDER,
+                            help="additional driver options, after '--'")
+
+    cmp_parser = sub.add_parser("compare", help="compare results against a baseline")
+    cmp_parser.add_argument("--baseline", required=True)
+    cmp_parser.add_argument("--current", required=True)
+    cmp_parser.add_argument("--time-threshold", type=float, default=0.10,
+                            help="allowed relative slowdown per phase (default: 0.10)")
+    cmp_parser.add_argument("--mem-threshold", type=float, default=0.05,
+                            help="allowed relative growth of peak arena memory (default: 0.05)")
+    cmp_parser.add_argument("--size-threshold", type=float, default=0.0,
+                            help="allowed relative growth of the binary size (default: 0)")
+    cmp_parser.add_argument("--min-time-us", type=float, default=500.0,
+                            help="ignore phases shorter than this in both runs (default: 500)")
+
+    args = parser.parse_args()
+    if args.command == "run":
+        if args.extra_args and args.extra_args[0] == "--":
+            args.extra_args = args.extra_args[1:]
+        return run(args)
+    if args.command == "compare":
+        return compare(args)
+    parser.print_help()
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,159 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include <functional>
+#include <unordered_map>
+#include "xcoder/ged_compaction_index.h"
+
+using std::unordered_map;
+
+
+namespace
+{
+struct TableKey
+{
+    ged_compaction_table_t _table;
+    uint64_t _valMask;
+
+    bool operator==(const TableKey& rhs) const { return _table == rhs._table && _valMask == rhs._valMask; }
+};
+
+struct TableKeyHash
+{
+    size_t operator()(const TableKey& key) const
+    {
+        return std::hash<const void*>()(key._table) ^ std::hash<uint64_t>()(key._valMask * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+// Small direct-mapped cache in front of the map: a compaction attempt probes only a handful of tables, so the same few indices are
+// requested over and over again.
+const unsigned int recentIndicesSize = 16;
+} // anonymous namespace
+
+
+/*************************************************************************************************
+ * class GEDCompactionIndex API functions
+ *************************************************************************************************/
+
+bool GEDCompactionIndex::Find(ged_compaction_table_t table, const uint32_t tableSize, const uint64_t val, const uint64_t valMask,
+                              uint32_t& index)
+{
+    const Slot* slot = Lookup(table, tableSize, val, valMask);
+    if (NULL == slot) return false;
+    index = slot->_first;
+    return true;
+}
+
+
+uint32_t GEDCompactionIndex::Count(ged_compaction_table_t table, const uint32_t tableSize, const uint64_t val, const uint64_t valMask)
+{
+    const Slot* slot = Lookup(table, tableSize, val, valMask);
+    return (NULL == slot) ? 0 : slot->_count;
+}
+
+
+/*************************************************************************************************
+ * class GEDCompactionIndex private functions
+ *************************************************************************************************/
+
+const GEDCompactionIndex::Slot* GEDCompactionIndex::Lookup(ged_compaction_table_t table, const uint32_t tableSize,
+                                                          const uint64_t val, const uint64_t valMask)
+{
+    const TableIndex& index = GetTableIndex(table, tableSize, valMask);
+    const uint64_t key = val | valMask;
+    const size_t mask = index._slots.size() - 1;
+    for (size_t i = Hash(key, index._shift); ; i = (i + 1) & mask)
+    {
+        const Slot& slot = index._slots[i];
+        if (0 == slot._count) return NULL; // the table is never full, so an empty slot terminates the probe sequence
+        if (key == slot._key) return &slot;
+    }
+}
+
+
+const GEDCompactionIndex::TableIndex& GEDCompactionIndex::GetTableIndex(ged_compaction_table_t table, const uint32_t tableSize,
+                                                                        const uint64_t valMask)
+{
+    static thread_local const TableIndex* recentIndices[recentIndicesSize] = { NULL };
+    static thread_local unordered_map<TableKey, TableIndex, TableKeyHash> indices;
+
+    const TableKey key = { table, valMask };
+    const size_t recent = TableKeyHash()(key) % recentIndicesSize;
+    const TableIndex* index = recentIndices[recent];
+    if (NULL != index && index->_table == table && index->_valMask == valMask)
+    {
+        GEDASSERT(index->_tableSize == tableSize);
+        return *index;
+    }
+
+    TableIndex& newIndex = indices[key];
+    if (NULL == newIndex._table)
+    {
+        newIndex._table = table;
+        newIndex._valMask = valMask;
+        newIndex._tableSize = tableSize;
+        BuildTableIndex(newIndex);
+    }
+    GEDASSERT(newIndex._tableSize == tableSize);
+    recentIndices[recent] = &newIndex; // unordered_map never moves its elements
+    return newIndex;
+}
+
+
+void GEDCompactionIndex::BuildTableIndex(TableIndex& index)
+{
+    GEDASSERT(0 != index._tableSize);
+    GEDASSERT(index._tableSize < GED_MAX_ENTRIES_IN_COMPACT_TABLE); // sanity check, also guarantees that indices fit in a byte
+
+    // Use at least twice as many slots as entries to keep the probe sequences short.
+    uint32_t log2Size = 1;
+    while ((1U << log2Size) < 2 * index._tableSize) ++log2Size;
+    index._shift = 64 - log2Size;
+    index._slots.assign(1U << log2Size, Slot());
+    const size_t mask = index._slots.size() - 1;
+
+    for (uint32_t i = 0; i < index._tableSize; ++i)
+    {
+        const uint64_t key = index._table[i] | index._valMask;
+        for (size_t s = Hash(key, index._shift); ; s = (s + 1) & mask)
+        {
+            Slot& slot = index._slots[s];
+            if (0 == slot._count)
+            {
+                slot._key = key;
+                slot._first = (uint8_t)i;
+                slot._count = 1;
+                break;
+            }
+            if (key == slot._key)
+            {
+                ++slot._count; // keep the first index, as the linear search did
+                break;
+            }
+        }
+    }
+}
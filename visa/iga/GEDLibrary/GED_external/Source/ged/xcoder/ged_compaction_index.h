@@ -0,0 +1,96 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#ifndef GED_COMPACTION_INDEX_H
+#define GED_COMPACTION_INDEX_H
+
+#include <vector>
+#include "common/ged_base.h"
+#include "common/ged_compact_mapping_table.h"
+
+using std::vector;
+
+
+/*!
+ * Hashed lookup of compaction table entries.
+ *
+ * When compacting, the value collected from the native instruction is matched against the field's compaction table under an
+ * or-mask of the reserved bits, i.e. entry i matches iff (table[i] | valMask) == (val | valMask). Instead of scanning the table for
+ * every probe, an open-addressed hash of the masked entries is built the first time a (table, mask) pair is seen and is reused
+ * afterwards. Compaction tables are static per-model data, so the index is effectively built once per model. The indices are
+ * kept per thread, which keeps lookups lock-free.
+ */
+class GEDCompactionIndex
+{
+public:
+    // STATIC FUNCTIONS
+
+    /*!
+     * Find the first entry in the given table which matches the given value under the given mask.
+     *
+     * @param[in]  table      The compaction table.
+     * @param[in]  tableSize  The number of entries in the table.
+     * @param[in]  val        The value to look for.
+     * @param[in]  valMask    The or-mask applied to both the value and the table entries.
+     * @param[out] index      The index of the first matching entry, undefined if no entry matches.
+     *
+     * @return     TRUE if a matching entry was found, FALSE otherwise.
+     */
+    static bool Find(ged_compaction_table_t table, const uint32_t tableSize, const uint64_t val, const uint64_t valMask,
+                     uint32_t& index);
+
+    /*!
+     * Count the entries in the given table which match the given value under the given mask.
+     */
+    static uint32_t Count(ged_compaction_table_t table, const uint32_t tableSize, const uint64_t val, const uint64_t valMask);
+
+private:
+    struct Slot
+    {
+        uint64_t _key;   // masked table entry
+        uint8_t _first;  // index of the first table entry with this key
+        uint8_t _count;  // number of table entries with this key, 0 for an empty slot
+    };
+
+    struct TableIndex
+    {
+        ged_compaction_table_t _table;
+        uint64_t _valMask;
+        uint32_t _tableSize;
+        uint32_t _shift;     // 64 - log2(_slots.size())
+        vector<Slot> _slots;
+    };
+
+    static const Slot* Lookup(ged_compaction_table_t table, const uint32_t tableSize, const uint64_t val, const uint64_t valMask);
+    static const TableIndex& GetTableIndex(ged_compaction_table_t table, const uint32_t tableSize, const uint64_t valMask);
+    static void BuildTableIndex(TableIndex& index);
+    static inline size_t Hash(const uint64_t key, const uint32_t shift)
+    {
+        return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+};
+
+#endif // GED_COMPACTION_INDEX_H
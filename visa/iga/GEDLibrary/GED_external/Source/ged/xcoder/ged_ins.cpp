@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 # include <algorithm>
 # endif
 #include "common/ged_string_utils.h"
+#include "xcoder/ged_compaction_index.h"
 #include "xcoder/ged_ins.h"
 
 using std::setw;
@@ -1042,17 +1043,10 @@ bool GEDIns::CountCurrentField(const ged_ins_decoding_table_t compactTable, cons
 bool GEDIns::CountCompactionTableEntry(uint64_t& val, const uint64_t& valMask, const uint32_t tableSize,
                                        ged_compaction_table_t table, unsigned int& count) const
 {
-    uint32_t counter = 0;
     GEDASSERT(0 != tableSize);
     GEDASSERT(tableSize < GED_MAX_ENTRIES_IN_COMPACT_TABLE); // sanity check
+    const uint32_t counter = GEDCompactionIndex::Count(table, tableSize, val, valMask);
     val |= valMask;
-    for (uint32_t i = 0; i < tableSize; ++i)
-    {
-        if ((table[i] | valMask) == val)
-        {
-            ++counter;
-        }
-    }
     count *= counter;
     return (0 != counter);
 }
@@ -1464,16 +1458,10 @@ bool GEDIns::FindCompactionTableEntry(uint64_t& val, const uint64_t& valMask, co
 {
     GEDASSERT(0 != tableSize);
     GEDASSERT(tableSize < GED_MAX_ENTRIES_IN_COMPACT_TABLE); // sanity check
-    val |= valMask;
-    for (uint32_t i = 0; i < tableSize; ++i)
-    {
-        if ((table[i] | valMask) == val)
-        {
-            val = i;
-            return true;
-        }
-    }
-    return false;
+    uint32_t index = 0;
+    if (!GEDCompactionIndex::Find(table, tableSize, val, valMask, index)) return false;
+    val = index;
+    return true;
 }
 
 
@@ -45,7 +45,8 @@ bool assemble(
     igax::Context &ctx,
     const std::string &inpFile,
     const std::string &inpText,
-    igax::Bits &bits)
+    igax::Bits &bits,
+    std::ostream &diags)
 {
     iga_assemble_options_t aopts = IGA_ASSEMBLE_OPTIONS_INIT();
     aopts.enabled_warnings = opts.enabledWarnings;
@@ -69,23 +70,23 @@ bool assemble(
     try {
         auto r = ctx.assembleFromString(inpText, aopts);
         for (auto &w : r.warnings) {
-            emitWarningToStderr(w, inpText);
+            emitWarning(diags, w, inpText);
         }
         bits = r.value;
         return true;
     } catch (const igax::AssembleError &err) {
         for (auto &e : err.errors) {
-            emitErrorToStderr(e, inpText);
+            emitError(diags, e, inpText);
         }
         if (err.errors.empty()) {
             // e.g. some failures don't have diagnostics
             //      invalid project for instance
-            err.emit(std::cerr);
+            err.emit(diags);
         }
         bits.clear();
     } catch (const igax::Error &err) {
         // some other error
-        err.emit(std::cerr);
+        err.emit(diags);
         bits.clear();
     }
     return false;
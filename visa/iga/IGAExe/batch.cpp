@@ -0,0 +1,285 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "iga_main.hpp"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// Batch mode (-Xbatch) processes many inputs in one process on a pool of
+// workers.  All workers share one context per platform for the whole batch
+// (igax::Context uses the reentrant API), so the model is set up once
+// rather than once per file.
+//
+// With -o the output of each input goes into that directory, named after
+// the input (inputs whose outputs would collide are rejected up front);
+// otherwise disassembly is streamed to stdout.  Either way
+// diagnostics and stdout output are emitted in input order as soon as
+// all earlier inputs have finished.
+
+struct BatchResult {
+    bool        done = false;
+    bool        success = false;
+    std::string text;        // disassembly streamed to stdout
+    std::string diagnostics; // buffered diagnostics
+};
+
+// one context per platform shared by all workers
+class BatchContexts {
+    std::mutex mutex;
+    std::map<iga_gen_t,std::unique_ptr<igax::Context>> contexts;
+public:
+    igax::Context &get(iga_gen_t p) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &ctx = contexts[p];
+        if (!ctx) {
+            ctx.reset(new igax::Context(p));
+        }
+        return *ctx;
+    }
+};
+
+
+// '@listfile' expands to the files listed in it (one per line) and
+// directories expand to the files they contain
+static void expandBatchInputs(
+    const Opts &opts,
+    std::vector<std::string> &files)
+{
+    for (const auto &inp : opts.inputFiles) {
+        if (!inp.empty() && inp[0] == '@') {
+            std::istringstream list(readTextFile(inp.c_str() + 1));
+            std::string line;
+            while (std::getline(list, line)) {
+                while (!line.empty() &&
+                    (line.back() == '\r' || line.back() == ' '))
+                {
+                    line.pop_back();
+                }
+                if (!line.empty()) {
+                    files.push_back(line);
+                }
+            }
+        } else if (isDirectory(inp.c_str())) {
+            listDirectoryFiles(inp.c_str(), files);
+        } else {
+            files.push_back(inp);
+        }
+    }
+}
+
+
+// e.g. (-d) foo.krn9 => DIR/foo.asm9 and (-a) foo.asm9 => DIR/foo.krn9
+static std::string batchOutputFile(
+    const Opts &opts,
+    const std::string &inpFile)
+{
+    std::string name = inpFile;
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        name = name.substr(slash + 1);
+    }
+    std::string sfx = opts.mode == Opts::Mode::DIS ? "asm" : "krn";
+    size_t dot = name.rfind('.');
+    if (dot != std::string::npos) {
+        std::string ext = name.substr(dot + 1);
+        name = name.substr(0, dot);
+        if (ext.size() >= 3) {
+            sfx += ext.substr(3); // keep the platform: krn9 => asm9
+        }
+    }
+    std::string dir = opts.outputFile;
+    if (dir.back() != '/' && dir.back() != '\\') {
+        dir += '/';
+    }
+    return dir + name + "." + sfx;
+}
+
+
+static void processBatchFile(
+    const Opts &baseOpts,
+    const std::string &inpFile,
+    BatchContexts &contexts,
+    BatchResult &result)
+{
+    std::stringstream diags;
+
+    Opts opts = baseOpts;
+    inferPlatformAndMode(inpFile, opts);
+    if (opts.mode == Opts::Mode::AUTO) {
+        diags << "cannot infer mode based on file extension"
+            " (use -d or -a to set mode)\n";
+    } else if (opts.platform == IGA_GEN_INVALID) {
+        diags << "cannot infer project based on file extension"
+            " (use -p=...)\n";
+    } else {
+        try {
+            igax::Context *ctx = &contexts.get(opts.platform);
+
+            if (opts.mode == Opts::Mode::DIS) {
+                std::vector<unsigned char> inp;
+                if (!tryReadBinaryFile(inpFile.c_str(), inp)) {
+                    diags << "failed to read file\n";
+                } else if (disassemble(opts, *ctx, inp, result.text, diags)) {
+                    result.success = true;
+                    if (!opts.outputFile.empty()) {
+                        std::string outFile = batchOutputFile(opts, inpFile);
+                        if (!tryWriteTextFile(
+                            outFile.c_str(),
+                            result.text.c_str(),
+                            result.text.size())) {
+                            diags << outFile << ": failed to write file\n";
+                            result.success = false;
+                        }
+                        result.text.clear();
+                    }
+                }
+            } else if (opts.mode == Opts::Mode::ASM) {
+                std::string inpText;
+                igax::Bits bits;
+                if (!tryReadTextFile(inpFile.c_str(), inpText)) {
+                    diags << "failed to read file\n";
+                } else if (assemble(opts, *ctx, inpFile, inpText, bits, diags)) {
+                    std::string outFile = batchOutputFile(opts, inpFile);
+                    result.success = tryWriteBinaryFile(
+                        outFile.c_str(),
+                        bits.data(),
+                        bits.size());
+                    if (!result.success) {
+                        diags << outFile << ": failed to write file\n";
+                    }
+                }
+            } else {
+                diags << "mode (-a or -d) must be specified for this file\n";
+            }
+        } catch (const igax::Error &err) {
+            err.emit(diags);
+        }
+    }
+
+    // diagnostic locations don't name the file
+    result.diagnostics = diags.str();
+    if (!result.diagnostics.empty()) {
+        result.diagnostics.insert(0, inpFile + ":\n");
+    }
+}
+
+
+bool processBatch(const Opts &opts)
+{
+    if (opts.inputFiles.empty()) {
+        fatalExitWithMessage("-Xbatch: at least one file required");
+    }
+    if (!opts.outputFile.empty() && !isDirectory(opts.outputFile.c_str())) {
+        fatalExitWithMessage(
+            "-Xbatch: %s: output (-o) must be an existing directory",
+            opts.outputFile.c_str());
+    }
+    if (opts.outputFile.empty() && opts.mode == Opts::Mode::ASM) {
+        fatalExitWithMessage(
+            "-Xbatch: assembly requires an output directory (-o)");
+    }
+
+    std::vector<std::string> files;
+    expandBatchInputs(opts, files);
+
+    // outputs are named after the input's file name alone, so inputs with
+    // the same name in different directories would overwrite each other
+    if (!opts.outputFile.empty()) {
+        std::map<std::string,std::string> outputs; // output => input
+        for (const auto &inpFile : files) {
+            Opts fileOpts = opts;
+            inferPlatformAndMode(inpFile, fileOpts);
+            if (fileOpts.mode != Opts::Mode::DIS &&
+                fileOpts.mode != Opts::Mode::ASM)
+            {
+                continue; // reported when the file is processed
+            }
+            auto ins = outputs.emplace(
+                batchOutputFile(fileOpts, inpFile), inpFile);
+            if (!ins.second) {
+                fatalExitWithMessage(
+                    "-Xbatch: %s and %s would both be written to %s",
+                    ins.first->second.c_str(),
+                    inpFile.c_str(),
+                    ins.first->first.c_str());
+            }
+        }
+    }
+    std::vector<BatchResult> results(files.size());
+
+    unsigned numThreads = opts.jobs;
+    if (numThreads == 0) {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    numThreads = std::min(numThreads, (unsigned)files.size());
+
+    std::mutex emitMutex;
+    size_t nextToEmit = 0;
+    bool hasError = false;
+    // emits the finished prefix of the inputs in order
+    auto finish = [&] (size_t ix) {
+        std::lock_guard<std::mutex> lock(emitMutex);
+        results[ix].done = true;
+        while (nextToEmit < files.size() && results[nextToEmit].done) {
+            BatchResult &r = results[nextToEmit];
+            std::cerr << r.diagnostics;
+            if (r.success && opts.outputFile.empty()) {
+                std::string hdr = "// " + files[nextToEmit] + "\n";
+                writeTextStream("<<stdout>>", std::cout, hdr.c_str(), hdr.size());
+                writeTextStream("<<stdout>>", std::cout, r.text.c_str(), r.text.size());
+            }
+            hasError |= !r.success;
+            r = BatchResult();
+            r.done = true;
+            nextToEmit++;
+        }
+    };
+
+    BatchContexts contexts;
+    std::atomic<size_t> nextFile(0);
+    auto worker = [&] () {
+        for (size_t ix = nextFile++; ix < files.size(); ix = nextFile++) {
+            processBatchFile(opts, files[ix], contexts, results[ix]);
+            finish(ix);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < numThreads; t++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    std::cout.flush();
+    return !hasError;
+}
@@ -31,6 +31,21 @@ bool disassemble(
     std::vector<unsigned char> inp;
     readBinaryFile(inpFile.c_str(), inp);
 
+    std::string text;
+    bool success = disassemble(opts, ctx, inp, text, std::cerr);
+    if (success) {
+        writeText(opts, text);
+    }
+    return success;
+}
+
+bool disassemble(
+    const Opts &opts,
+    igax::Context &ctx,
+    const std::vector<unsigned char> &inp,
+    std::string &text,
+    std::ostream &diags)
+{
     iga_disassemble_options_t dopts = IGA_DISASSEMBLE_OPTIONS_INIT();
     setOptBit(dopts.formatting_opts,
         IGA_FORMATTING_OPT_NUMERIC_LABELS,
@@ -59,23 +74,23 @@ bool disassemble(
     try {
         auto r = ctx.disassembleToString(inp.data(), inp.size(), dopts);
         for (auto &w : r.warnings) {
-            emitWarningToStderr(w, inp);
+            emitWarning(diags, w, inp);
         }
-        writeText(opts, r.value);
+        text = r.value;
         return true;
     } catch (const igax::DisassembleError &err) {
         // some error where we can report several potentially
         for (auto &e : err.errors) {
-            emitErrorToStderr(e, inp);
+            emitError(diags, e, inp);
         }
         if (err.errors.empty()) {
             // e.g. some failures don't have diagnostics
             //      invalid project for instance
-            err.emit(std::cerr);
+            err.emit(diags);
         }
     } catch (const igax::Error &err) {
         // some other error
-        err.emit(std::cerr);
+        err.emit(diags);
     }
     return false;
 }
@@ -280,6 +280,25 @@ extern "C" int iga_main(int argc, const char **argv)
         "the compacted form does not exist.",
         opts::OptAttrs::ALLOW_UNSET,
         baseOpts.autoCompact);
+    xGrp.defineFlag(
+        "batch",
+        nullptr,
+        "processes many inputs in one process",
+        "This mode assembles or disassembles all the inputs on a pool of "
+        "worker threads (see -Xjobs).  An input can be a file, a directory "
+        "(all files in it) or @LIST (each line of LIST names a file).  Mode "
+        "and platform are inferred per file as usual.  With -o, the output "
+        "of each input is written to that directory named after the input "
+        "(foo.krn9 => DIR/foo.asm9); inputs that would write the same "
+        "output (e.g. a/foo.krn9 and b/foo.krn9) are rejected before any "
+        "work starts.  Without -o, disassembly is streamed to stdout in "
+        "input order.\n"
+        "\n"
+        "EXAMPLES:\n"
+        "  % iga -Xbatch -p=9 -d dumps/ -o asm/\n"
+        "    disassembles every file in dumps/ into asm/\n",
+        opts::OptAttrs::ALLOW_UNSET,
+        baseOpts.batch);
     xGrp.defineFlag(
         "dcmp",
         nullptr,
@@ -325,6 +344,21 @@ extern "C" int iga_main(int argc, const char **argv)
         [] (const char *, const opts::ErrorHandler &, Opts &baseOpts) {
             baseOpts.mode = Opts::Mode::XIFS;
         });
+    xGrp.defineOpt(
+        "jobs",
+        nullptr,
+        "INT",
+        "number of worker threads for -Xbatch",
+        "The default (0) uses all available cores.",
+        opts::OptAttrs::ALLOW_UNSET,
+        [] (const char *cinp, const opts::ErrorHandler &err, Opts &baseOpts) {
+            char *end = nullptr;
+            long n = strtol(cinp, &end, 10);
+            if (end == cinp || *end != 0 || n < 0) {
+                err("invalid job count");
+            }
+            baseOpts.jobs = (unsigned)n;
+        });
     xGrp.defineFlag(
         "ldst-syntax",
         nullptr,
@@ -375,6 +409,22 @@ extern "C" int iga_main(int argc, const char **argv)
         [] (const char *cinp, const opts::ErrorHandler &, Opts &baseOpts) {
             baseOpts.printLdSt = false;
         });
+    xGrp.defineFlag(
+        "op-histogram",
+        nullptr,
+        "counts the ops in kernel binaries",
+        "This mode decodes the input binaries one instruction at a time "
+        "(the kernel is never held in memory) and lists how many times each "
+        "op occurs across all the inputs, most frequent first.  All inputs "
+        "must be for the same platform.\n"
+        "\n"
+        "EXAMPLES:\n"
+        "  % iga -Xop-histogram foo.krn9 bar.krn9\n"
+        "    counts the ops in foo.krn9 and bar.krn9 (-p=9 inferred)\n",
+        opts::OptAttrs::ALLOW_UNSET,
+        [] (const char *, const opts::ErrorHandler &, Opts &baseOpts) {
+            baseOpts.mode = Opts::Mode::XOPH;
+        });
     xGrp.defineFlag(
         "syntax-exts",
         nullptr,
@@ -486,6 +536,10 @@ extern "C" int iga_main(int argc, const char **argv)
         hasError |= debugCompaction(baseOpts);
     } else if (baseOpts.mode == Opts::XDSD) {
         hasError |= decodeSendDescriptor(baseOpts);
+    } else if (baseOpts.mode == Opts::XOPH) {
+        hasError |= opHistogram(baseOpts);
+    } else if (baseOpts.batch) {
+        hasError |= !processBatch(baseOpts);
     } else {
         if (baseOpts.inputFiles.empty()) {
             fatalExitWithMessage("at least one file required");
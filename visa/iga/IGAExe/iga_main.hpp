@@ -52,8 +52,9 @@ struct Opts {
     // XLST = -Xlist-ops (list ops for a given platform)
     // XIFS = -Xifs (decode fields)
     // XDCMP = -Xdcmp (debug compaction)
+    // XOPH = -Xop-histogram (count ops in binaries)
     // AUTO = operate based on input (see inferPlatformAndMode below)
-    enum Mode {ASM, DIS, XLST, XIFS, XDCMP, XDSD, AUTO};
+    enum Mode {ASM, DIS, XLST, XIFS, XDCMP, XDSD, XOPH, AUTO};
 
     std::vector<std::string> inputFiles;             // .empty() means stdin
     std::string outputFile;                          // "" means stdout
@@ -74,6 +75,9 @@ struct Opts {
     bool printHexFloats      = false;                // -Xprint-hex-floats
     bool printLdSt           = false;                // -Xprint-ldst
     bool printInstructionPc  = false;                // -Xprint-pc
+
+    bool batch               = false;                // -Xbatch
+    unsigned jobs            = 0;                    // -Xjobs (0 means all cores)
 };
 
 
@@ -81,6 +85,12 @@ bool disassemble(
     const Opts &opts,
     igax::Context &ctx,
     const std::string &inpFile); // -d: disassemble.cpp
+bool disassemble(
+    const Opts &opts,
+    igax::Context &ctx,
+    const std::vector<unsigned char> &inp,
+    std::string &text,
+    std::ostream &diags); // disassemble.cpp
 bool assemble(
     const Opts &opts,
     igax::Context &ctx,
@@ -90,7 +100,10 @@ bool assemble(
     igax::Context &ctx,
     const std::string &inpFile,
     const std::string &inpText,
-    igax::Bits &bits); // assemble.cpp
+    igax::Bits &bits,
+    std::ostream &diags = std::cerr); // assemble.cpp
+bool processBatch(
+    const Opts &opts); // -Xbatch: batch.cpp
 bool decodeInstructionFields(
     const Opts &baseOpts); // -Xifs in decode_fields.cpp
 bool debugCompaction(
@@ -100,6 +113,8 @@ bool listOps(
     const std::string &opmn); // -Xlist-ops: list_ops.cpp
 bool decodeSendDescriptor(
     const Opts &opts); // -Xsds in decode_message.cpp
+bool opHistogram(
+    const Opts &opts); // -Xop-histogram: list_ops.cpp
 
 static void setOptBit(uint32_t &opts, uint32_t bit, bool isSet) {
     if (isSet) {
@@ -152,50 +167,56 @@ static void writeBinary(const Opts &opts, const void *bits, size_t bitsLen) {
     } while (0)
 
 
-static void emitWarningToStderr(
+// diagnostics go to std::cerr except in batch mode, where each file's
+// diagnostics are buffered so they don't interleave with other files'
+static void emitWarning(
+    std::ostream &os,
     const igax::Diagnostic &w,
     const std::string &inp)
 {
-    w.emitLoc(std::cerr);
-    std::cerr << " warning: ";
-    emitYellowText(std::cerr, w.message);
-    std::cerr << "\n";
+    w.emitLoc(os);
+    os << " warning: ";
+    emitYellowText(os, w.message);
+    os << "\n";
 
-    w.emitContext(std::cerr, inp);
+    w.emitContext(os, inp);
 }
-static void emitWarningToStderr(
+static void emitWarning(
+    std::ostream &os,
     const igax::Diagnostic &w,
     const std::vector<unsigned char> &inp)
 {
 
-    w.emitLoc(std::cerr);
-    std::cerr << " warning: ";
-    emitYellowText(std::cerr, w.message);
-    std::cerr << "\n";
+    w.emitLoc(os);
+    os << " warning: ";
+    emitYellowText(os, w.message);
+    os << "\n";
 
-    w.emitContext(std::cerr, "", inp.data(), inp.size());
+    w.emitContext(os, "", inp.data(), inp.size());
 }
-static void emitErrorToStderr(
+static void emitError(
+    std::ostream &os,
     const igax::Diagnostic &e,
     const std::string &inp)
 {
-    e.emitLoc(std::cerr);
-    std::cerr << " error: ";
-    emitRedText(std::cerr, e.message);
-    std::cerr << "\n";
+    e.emitLoc(os);
+    os << " error: ";
+    emitRedText(os, e.message);
+    os << "\n";
 
-    e.emitContext(std::cerr, inp);
+    e.emitContext(os, inp);
 }
-static void emitErrorToStderr(
+static void emitError(
+    std::ostream &os,
     const igax::Diagnostic &e,
     const std::vector<unsigned char> &inp)
 {
-    e.emitLoc(std::cerr);
-    std::cerr << " error: ";
-    emitRedText(std::cerr, e.message);
-    std::cerr << "\n";
+    e.emitLoc(os);
+    os << " error: ";
+    emitRedText(os, e.message);
+    os << "\n";
 
-    e.emitContext(std::cerr, "", inp.data(), inp.size());
+    e.emitContext(os, "", inp.data(), inp.size());
 }
 
 static void inferPlatformAndMode(
@@ -238,6 +259,7 @@ static void ensurePlatformIsSet(const Opts &opts)
           opts.mode == Opts::Mode::XIFS ? "ifs" :
           opts.mode == Opts::Mode::XDCMP ? "dcmp" :
           opts.mode == Opts::Mode::XDSD ? "dsd" :
+          opts.mode == Opts::Mode::XOPH ? "op-histogram" :
             "???";
 
         fatalExitWithMessage("-X%s: unable to infer platform (use -p)", tool);
@@ -32,9 +32,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #else
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <dirent.h>
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <iostream>
@@ -188,6 +190,113 @@ static bool doesFileExist(const char *fileName) {
 #endif
 }
 
+// Non-fatal readers for batch mode: a bad input only fails that file.
+static bool tryReadBinaryFile(
+    const char *fileName,
+    std::vector<unsigned char> &bin)
+{
+    std::ifstream is(fileName, std::ios::binary);
+    if (!is.is_open()) {
+        return false;
+    }
+    bin.assign(std::istreambuf_iterator<char>(is),
+               std::istreambuf_iterator<char>());
+    return !is.bad();
+}
+
+static bool tryReadTextFile(
+    const char *fileName,
+    std::string &text)
+{
+    std::ifstream is(fileName);
+    if (!is.is_open()) {
+        return false;
+    }
+    text.assign(std::istreambuf_iterator<char>(is),
+                std::istreambuf_iterator<char>());
+    return !is.bad();
+}
+
+// Non-fatal writers for batch mode: a failed output only fails that file.
+static bool tryWriteTextFile(
+    const char *fileName,
+    const char *output,
+    size_t outputLength)
+{
+    std::ofstream os(fileName);
+    if (!os.is_open()) {
+        return false;
+    }
+    os.write(output, outputLength);
+    os.close();
+    return !os.fail();
+}
+
+static bool tryWriteBinaryFile(
+    const char *fileName,
+    const void *bits,
+    size_t bitsLen)
+{
+    std::ofstream os(fileName, std::ios::binary);
+    if (!os.is_open()) {
+        return false;
+    }
+    os.write((const char *)bits, bitsLen);
+    os.close();
+    return !os.fail();
+}
+
+static bool isDirectory(const char *path) {
+#ifdef _WIN32
+    DWORD dwAttrib = GetFileAttributesA(path);
+    return (dwAttrib != INVALID_FILE_ATTRIBUTES &&
+            (dwAttrib & FILE_ATTRIBUTE_DIRECTORY));
+#else
+    struct stat sb = {0};
+    return stat(path, &sb) == 0 && S_ISDIR(sb.st_mode);
+#endif
+}
+
+// appends the regular files in a directory (non-recursive) in sorted order
+static void listDirectoryFiles(
+    const char *dirName,
+    std::vector<std::string> &files)
+{
+    std::vector<std::string> found;
+    std::string dir = dirName;
+    if (!dir.empty() && dir.back() != '/' && dir.back() != '\\') {
+        dir += '/';
+    }
+#ifdef _WIN32
+    WIN32_FIND_DATAA ffd;
+    HANDLE h = FindFirstFileA((dir + "*").c_str(), &ffd);
+    if (h == INVALID_HANDLE_VALUE) {
+        fatalExitWithMessage("iga: %s: failed to list directory", dirName);
+    }
+    do {
+        if (!(ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+            found.push_back(dir + ffd.cFileName);
+        }
+    } while (FindNextFileA(h, &ffd));
+    FindClose(h);
+#else
+    DIR *d = opendir(dirName);
+    if (d == nullptr) {
+        fatalExitWithMessage("iga: %s: failed to list directory", dirName);
+    }
+    while (struct dirent *de = readdir(d)) {
+        std::string path = dir + de->d_name;
+        struct stat sb = {0};
+        if (stat(path.c_str(), &sb) == 0 && S_ISREG(sb.st_mode)) {
+            found.push_back(path);
+        }
+    }
+    closedir(d);
+#endif
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+}
+
 // Use the color API's below.
 //   emitRedText(std::ostream&,const T&)
 //   emit###Text(std::ostream&,const T&)
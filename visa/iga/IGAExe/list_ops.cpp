@@ -25,6 +25,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 #include "iga_main.hpp"
 
+#include "api/kv.h"
+
+#include <map>
 #include <sstream>
 
 
@@ -82,3 +85,83 @@ bool listOps(const Opts &opts, const std::string &opmn)
     writeText(opts, ss.str().c_str());
     return hasError;
 }
+
+
+bool opHistogram(const Opts &baseOpts)
+{
+    if (baseOpts.inputFiles.empty()) {
+        fatalExitWithMessage("-Xop-histogram: at least one file required");
+    }
+    iga_gen_t platform = baseOpts.platform;
+
+    // counts keyed by iga::Op
+    std::map<uint32_t,uint64_t> counts;
+    uint64_t total = 0;
+    bool hasError = false;
+    for (const auto &inpFile : baseOpts.inputFiles) {
+        Opts opts = baseOpts;
+        inferPlatformAndMode(inpFile, opts);
+        ensurePlatformIsSet(opts);
+        if (platform == IGA_GEN_INVALID) {
+            platform = opts.platform;
+        } else if (opts.platform != platform) {
+            fatalExitWithMessage(
+                "-Xop-histogram: %s: inputs are for different platforms",
+                inpFile.c_str());
+        }
+
+        std::vector<unsigned char> inp;
+        readBinaryFile(inpFile.c_str(), inp);
+
+        iga_status_t st = IGA_SUCCESS;
+        kv_stream_t *kvs = kv_stream_create(
+            platform, inp.data(), inp.size(), &st);
+        if (kvs == nullptr) {
+            fatalExitWithMessage(
+                "-Xop-histogram: %s: %s",
+                inpFile.c_str(), iga_status_to_string(st));
+        }
+        while (kv_stream_next(kvs) != KV_INVALID_PC_VALUE) {
+            counts[kv_stream_get_opcode(kvs)]++;
+            total++;
+        }
+        if (kv_stream_has_errors(kvs)) {
+            std::cerr << inpFile << ": decode errors (counted as illegal)\n";
+            hasError = true;
+        }
+        kv_stream_delete(kvs);
+    }
+
+    std::map<uint32_t,std::string> mnemonics;
+    for (const auto &op : igax::OpSpec::enumerate(
+        static_cast<igax::Platform>(platform)))
+    {
+        mnemonics[static_cast<uint32_t>(op.op())] = opFullMnemonic(op);
+    }
+
+    std::vector<std::pair<uint32_t,uint64_t>> sorted(
+        counts.begin(), counts.end());
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [] (const std::pair<uint32_t,uint64_t> &a,
+            const std::pair<uint32_t,uint64_t> &b) {
+            return a.second > b.second;
+        });
+
+    std::stringstream ss;
+    ss << std::setw(12) << std::left << "Mnemonic" << "  " <<
+        std::setw(10) << std::right << "Count" << "  " <<
+        std::setw(7) << "Percent" << "\n";
+    for (const auto &e : sorted) {
+        auto itr = mnemonics.find(e.first);
+        const std::string mn =
+            itr != mnemonics.end() ? itr->second : "illegal";
+        ss << std::setw(12) << std::left << mn << "  " <<
+            std::setw(10) << std::right << e.second << "  " <<
+            std::setw(6) << std::fixed << std::setprecision(2) <<
+            100.0 * e.second / total << "%\n";
+    }
+    ss << std::setw(12) << std::left << "total" << "  " <<
+        std::setw(10) << std::right << total << "\n";
+    writeText(baseOpts, ss.str());
+    return hasError;
+}
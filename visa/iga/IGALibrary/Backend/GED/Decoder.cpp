@@ -101,12 +101,24 @@ DecoderBase::DecoderBase(const Model &model, ErrorHandler &errHandler) :
     GEDBitProcessor(model,errHandler),
     m_kernel(nullptr),
     m_gedModel(IGAToGEDTranslation::lowerPlatform(model.platform)),
-    m_opSpec(nullptr)
+    m_opSpec(nullptr),
+    m_streamKernel(nullptr),
+    m_streamInst(nullptr),
+    m_streamNext(nullptr),
+    m_streamBytesLeft(0),
+    m_streamInstLen(0),
+    m_streamNextId(0)
 {
     IGA_ASSERT(m_gedModel != GED_MODEL_INVALID, "invalid GED model");
 }
 
 
+DecoderBase::~DecoderBase()
+{
+    endStream();
+}
+
+
 Kernel *DecoderBase::decodeKernelBlocks(
     const void *binary,
     size_t binarySize)
@@ -217,90 +229,162 @@ void DecoderBase::decodeInstructions(
     int32_t bytesLeft =  (int32_t)binarySize;
     while (bytesLeft > 0)
     {
-        // need at least 4 bytes to check compaction control
-        if (bytesLeft < 4) {
-            warning("unexpected padding at end of kernel");
+        int32_t iLen = 0;
+        Instruction *inst =
+            decodeInstructionAt(kernel, binary, bytesLeft, nextId++, iLen);
+        if (inst == nullptr) {
             break;
         }
-        // ensure there's enough buffer left
-        int32_t iLen = getBitField(COMPACTION_CONTROL,1) != 0 ?
-            COMPACTED_SIZE :
-            UNCOMPACTED_SIZE;
-        if (bytesLeft < iLen) {
-            warning("unexpected padding at end of kernel");
-            break;
-        }
-        memset(&m_currGedInst, 0, sizeof(m_currGedInst));
-        GED_RETURN_VALUE status =
-            GED_DecodeIns(m_gedModel, binary, (uint32_t)binarySize, &m_currGedInst);
-        Instruction *inst = nullptr;
-        if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
-            error("error decoding instruction (no compacted form)");
-            inst = createErrorInstruction(
-                kernel,
-                "unable to decompact",
-                binary,
-                iLen);
-            // fall through: GED can sort of decode some things here
-        } else if (status != GED_RETURN_VALUE_SUCCESS) {
-            error("error decoding instruction");
+        insts.emplace_back(inst);
+        advancePc(iLen);
+        binary += iLen;
+        bytesLeft -= iLen;
+    }
+
+}
+
+// Decodes the instruction at the current PC ('binary' points at it);
+// returns nullptr if only padding remains
+Instruction *DecoderBase::decodeInstructionAt(
+    Kernel &kernel,
+    const unsigned char *binary,
+    int32_t bytesLeft,
+    uint32_t id,
+    int32_t &iLen)
+{
+    // need at least 4 bytes to check compaction control
+    if (bytesLeft < 4) {
+        warning("unexpected padding at end of kernel");
+        return nullptr;
+    }
+    // ensure there's enough buffer left
+    iLen = getBitField(COMPACTION_CONTROL,1) != 0 ?
+        COMPACTED_SIZE :
+        UNCOMPACTED_SIZE;
+    if (bytesLeft < iLen) {
+        warning("unexpected padding at end of kernel");
+        return nullptr;
+    }
+    memset(&m_currGedInst, 0, sizeof(m_currGedInst));
+    GED_RETURN_VALUE status =
+        GED_DecodeIns(m_gedModel, binary, (uint32_t)bytesLeft, &m_currGedInst);
+    Instruction *inst = nullptr;
+    if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
+        error("error decoding instruction (no compacted form)");
+        inst = createErrorInstruction(
+            kernel,
+            "unable to decompact",
+            binary,
+            iLen);
+        // fall through: GED can sort of decode some things here
+    } else if (status != GED_RETURN_VALUE_SUCCESS) {
+        error("error decoding instruction");
+        inst = createErrorInstruction(
+            kernel,
+            "GED error decoding instruction",
+            binary,
+            iLen);
+    } else {
+        Op op = GEDToIGATranslation::translate(GED_GetOpcode(&m_currGedInst));
+        m_opSpec = decodeOpSpec(op);
+        if (m_opSpec->op == Op::INVALID) {
+            // figure out if we failed to resolve the primary op
+            // or if it's an unmapped subfunction (e.g. math function)
+            auto os = m_model.lookupOpSpec(op);
+            std::stringstream ss;
+            if (os.format == OpSpec::GROUP) {
+                ss << "unsupported pseudo op (sub function of " <<
+                    os.mnemonic << ")";
+            } else {
+                ss << std::hex << "0x" << (unsigned)op <<
+                    ": unsupported opcode on this platform";
+            }
+            std::string str = ss.str();
+            error("%s", str.c_str());
             inst = createErrorInstruction(
                 kernel,
-                "GED error decoding instruction",
+                str.c_str(),
                 binary,
                 iLen);
         } else {
-            Op op = GEDToIGATranslation::translate(GED_GetOpcode(&m_currGedInst));
-            m_opSpec = decodeOpSpec(op);
-            if (m_opSpec->op == Op::INVALID) {
-                // figure out if we failed to resolve the primary op
-                // or if it's an unmapped subfunction (e.g. math function)
-                auto os = m_model.lookupOpSpec(op);
-                std::stringstream ss;
-                if (os.format == OpSpec::GROUP) {
-                    ss << "unsupported pseudo op (sub function of " <<
-                        os.mnemonic << ")";
-                } else {
-                    ss << std::hex << "0x" << (unsigned)op <<
-                        ": unsupported opcode on this platform";
-                }
-                std::string str = ss.str();
-                error("%s", str.c_str());
+            try {
+                inst = decodeNextInstruction(kernel);
+            } catch (const FatalError &fe) {
+                // error is already logged
                 inst = createErrorInstruction(
                     kernel,
-                    str.c_str(),
+                    fe.what(),
                     binary,
                     iLen);
-            } else {
-                try {
-                    inst = decodeNextInstruction(kernel);
-                } catch (const FatalError &fe) {
-                    // error is already logged
-                    inst = createErrorInstruction(
-                        kernel,
-                        fe.what(),
-                        binary,
-                        iLen);
-                }
             }
         }
-        inst->setPC(currentPc());
-        inst->setID(nextId++);
-        insts.emplace_back(inst);
-        inst->setLoc(currentPc());
+    }
+    inst->setPC(currentPc());
+    inst->setID(id);
+    inst->setLoc(currentPc());
 #if _DEBUG
-        if (!errorHandler().hasErrors()) {
-            // only validate if there weren't errors
-            inst->validate();
-        }
+    if (!errorHandler().hasErrors()) {
+        // only validate if there weren't errors
+        inst->validate();
+    }
 #endif
-        advancePc(iLen);
-        binary += iLen;
-        bytesLeft -= iLen;
+    return inst;
+}
+
+
+void DecoderBase::beginStream(
+    const void *binary,
+    size_t binarySize)
+{
+    endStream();
+    m_binary = binary;
+    m_streamNext = (const unsigned char *)binary;
+    m_streamBytesLeft = (int32_t)binarySize;
+    m_streamNextId = 1;
+    m_streamKernel = new Kernel(m_model);
+    restart();
+}
+
+
+const Instruction *DecoderBase::decodeNextStreamed()
+{
+    IGA_ASSERT(m_streamKernel != nullptr, "beginStream not called");
+    if (m_streamInst) {
+        // the previous instruction's storage is recycled for this one
+        advancePc(m_streamInstLen);
+        m_streamNext += m_streamInstLen;
+        m_streamBytesLeft -= m_streamInstLen;
+        m_streamInst->~Instruction();
+        m_streamInst = nullptr;
+        m_streamKernel->getMemManager().reset();
+    }
+    if (m_streamBytesLeft <= 0) {
+        return nullptr;
+    }
+    m_streamInst = decodeInstructionAt(
+        *m_streamKernel,
+        m_streamNext,
+        m_streamBytesLeft,
+        m_streamNextId++,
+        m_streamInstLen);
+    if (m_streamInst == nullptr) {
+        m_streamBytesLeft = 0; // trailing padding
     }
+    return m_streamInst;
+}
+
 
+void DecoderBase::endStream()
+{
+    if (m_streamInst) {
+        m_streamInst->~Instruction();
+        m_streamInst = nullptr;
+    }
+    delete m_streamKernel;
+    m_streamKernel = nullptr;
 }
 
+
 void DecoderBase::decodeNextInstructionEpilog(Instruction *inst)
 {
 }
@@ -49,6 +49,7 @@ namespace iga
     public:
         // Constructs a new decoder with an error handler and an empty kernel
         DecoderBase(const Model &model, ErrorHandler &errHandler);
+        ~DecoderBase();
 
         // the main entry point for decoding a kernel
         Kernel *decodeKernelBlocks(
@@ -58,6 +59,22 @@ namespace iga
             const void *binary,
             size_t binarySize);
 
+        // Streaming decode: decodes one instruction per call without
+        // building a Kernel.  Each instruction is decoded into a scratch
+        // slot whose memory is recycled on the next call, so memory use is
+        // constant in the binary size.  The returned instruction is only
+        // valid until the next call (or endStream()) and uses numeric
+        // labels.  Returns nullptr once the binary is exhausted.
+        //
+        //   decoder.beginStream(bits, bitsLen);
+        //   while (const Instruction *inst = decoder.decodeNextStreamed())
+        //       ...
+        void beginStream(
+            const void *binary,
+            size_t binarySize);
+        const Instruction *decodeNextStreamed();
+        void endStream();
+
 
     private:
         Kernel *decodeKernel(
@@ -71,6 +88,12 @@ namespace iga
             const void *binary,
             size_t binarySize,
             InstList &insts);
+        Instruction *decodeInstructionAt(
+            Kernel &kernel,
+            const unsigned char *binary,
+            int32_t bytesLeft,
+            uint32_t id,
+            int32_t &iLen);
         const OpSpec *decodeOpSpec(Op op);
 
         Instruction *decodeNextInstruction(Kernel &kernel);
@@ -328,6 +351,14 @@ namespace iga
         const OpSpec                 *m_opSpec;
         const void                   *m_binary;
 
+        // streaming state (valid between beginStream and endStream)
+        Kernel                       *m_streamKernel; // scratch allocator
+        Instruction                  *m_streamInst;
+        const unsigned char          *m_streamNext;
+        int32_t                       m_streamBytesLeft;
+        int32_t                       m_streamInstLen;
+        uint32_t                      m_streamNextId;
+
         // for GED workarounds: grab specific bits from the current instruction
         uint32_t getBitField(int ix, int len) const;
 
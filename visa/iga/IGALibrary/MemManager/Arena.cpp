@@ -69,3 +69,14 @@ void ArenaManager::FreeArenas()
 
     _arenas = 0;
 }
+
+void ArenaManager::ResetArenas()
+{
+    // the oldest arena is the default-sized one made by the constructor
+    while (_arenas->_nextArena) {
+        unsigned char* killed = (unsigned char*)_arenas;
+        _arenas = _arenas->_nextArena;
+        delete [] killed;
+    }
+    _arenas->_nextByte = _arenas->GetArenaData();
+}
@@ -191,6 +191,8 @@ private:
     }
 
     void FreeArenas();
+    // Frees all but the initial arena and rewinds it for reuse
+    void ResetArenas();
 
     // Data
 
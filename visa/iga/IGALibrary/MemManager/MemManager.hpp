@@ -46,6 +46,13 @@ public:
         return _arenaManager.AllocDataSpace(size);
     }
 
+    // Releases everything allocated so far; the memory is retained and
+    // reused by later allocations.  No destructors are run.
+    void reset()
+    {
+        _arenaManager.ResetArenas();
+    }
+
 private:
     ArenaManager   _arenaManager;
 
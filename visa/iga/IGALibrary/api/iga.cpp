@@ -15,6 +15,7 @@
 // external dependencies
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <map>
 #include <vector>
 #include <ostream>
@@ -264,13 +265,21 @@ public:
     }
 
 
-    iga_status_t assemble(
+    // Parses and encodes a kernel without touching any context state; so
+    // this may run concurrently.  Upon success 'bits' points into memory
+    // owned by 'kernel', which the caller must delete (even on failure).
+    iga_status_t assembleKernel(
+        iga::ErrorHandler &errHandler,
         iga_assemble_options_t &aopts,
         const char *inp,
-        void **bits,
-        uint32_t *bitsLen32)
+        Kernel *&kernel,
+        void *&bits,
+        size_t &bitsLen) const
     {
-        iga::ErrorHandler errHandler;
+        kernel = nullptr;
+        bits = nullptr;
+        bitsLen = 0;
+
         // compatibility for legacy fields
         bool used_legacy_fields = false;
         if (aopts._reserved0) { // used to be error_on_compact_fail
@@ -289,53 +298,28 @@ public:
         ParseOpts popts(m_model);
         popts.supportLegacyDirectives =
             (aopts.syntax_opts & IGA_SYNTAX_OPT_LEGACY_SYNTAX) != 0;
-        Kernel *kernel = iga::ParseGenKernel(m_model, inp, errHandler, popts);
+        kernel = iga::ParseGenKernel(m_model, inp, errHandler, popts);
         if (kernel && !errHandler.hasErrors() && aopts.enabled_warnings) {
             // check semantics if we parsed without error && they haven't
             // disabled all checking (-Wnone)
             CheckSemantics(*kernel, errHandler, aopts.enabled_warnings);
         }
         if (errHandler.hasErrors()) {
-            *bits = nullptr;
-            *bitsLen32 = 0;
-            iga_status_t st = translateDiagnostics(errHandler);
-            if (st != IGA_SUCCESS)
-                return st;
             return IGA_PARSE_ERROR;
         }
 
-        if (errHandler.hasErrors()) {
-            *bits = nullptr;
-            *bitsLen32 = 0;
-            iga_status_t st = translateDiagnostics(errHandler);
-            if (st != IGA_SUCCESS) {
-                return st;
-            }
-            delete kernel;
-            return st == IGA_SUCCESS ? IGA_ENCODE_ERROR : st;
-        }
-
-        // 3. Encode the final IR into bits
-        //
-        // clobber the last assembly's bits
-        if (m_assemble_bits) {
-            free(m_assemble_bits);
-            m_assemble_bits = nullptr;
-        }
-        size_t bitsLen = 0;
+        // 2. Encode the final IR into bits
         EncoderOpts eopts(
               (aopts.encoder_opts & IGA_ENCODER_OPT_AUTO_COMPACT) != 0,
               (aopts.encoder_opts & IGA_ENCODER_OPT_ERROR_ON_COMPACT_FAIL) == 0);
 
         if ((aopts.encoder_opts & IGA_ENCODER_OPT_USE_NATIVE) == 0) {
             if (!iga::ged::IsEncodeSupported(m_model, eopts)) {
-                delete kernel;
                 return IGA_UNSUPPORTED_PLATFORM;
             }
-            iga::ged::Encode(m_model, eopts, errHandler, *kernel, *bits, bitsLen);
+            iga::ged::Encode(m_model, eopts, errHandler, *kernel, bits, bitsLen);
         } else {
             if (!iga::native::IsEncodeSupported(m_model, eopts)) {
-                delete kernel;
                 return IGA_UNSUPPORTED_PLATFORM;
             }
             iga::native::Encode(
@@ -343,26 +327,58 @@ public:
                 eopts,
                 errHandler,
                 *kernel,
-                *bits,
+                bits,
                 bitsLen);
         }
-        *bitsLen32 = (uint32_t)bitsLen;
         if (errHandler.hasErrors()) {
             // failed encoding
+            bits = nullptr;
+            bitsLen = 0;
+            return IGA_ENCODE_ERROR;
+        }
+        return IGA_SUCCESS;
+    }
+
+
+    iga_status_t assemble(
+        iga_assemble_options_t &aopts,
+        const char *inp,
+        void **bits,
+        uint32_t *bitsLen32)
+    {
+        // clobber the last assembly's bits
+        if (m_assemble_bits) {
+            free(m_assemble_bits);
+            m_assemble_bits = nullptr;
+        }
+        *bits = nullptr;
+        *bitsLen32 = 0;
+
+        iga::ErrorHandler errHandler;
+        Kernel *kernel = nullptr;
+        void *kernelBits = nullptr;
+        size_t bitsLen = 0;
+        iga_status_t st = assembleKernel(
+            errHandler, aopts, inp, kernel, kernelBits, bitsLen);
+        if (st == IGA_UNSUPPORTED_PLATFORM) {
+            delete kernel;
+            return st;
+        } else if (st != IGA_SUCCESS) {
             delete kernel;
-            iga_status_t st = translateDiagnostics(errHandler);
-            return st == IGA_SUCCESS ? IGA_ENCODE_ERROR : st;
+            iga_status_t dst = translateDiagnostics(errHandler);
+            return dst == IGA_SUCCESS ? st : dst;
         }
 
-        // 4. Copy out the result
+        // 3. Copy out the result
         // encoding succeeded, copy the bits out
-        m_assemble_bits = (void *)malloc(*bitsLen32);
+        m_assemble_bits = (void *)malloc(bitsLen);
         if (!m_assemble_bits) {
             delete kernel;
             return IGA_OUT_OF_MEM;
         }
-        MEMCPY(m_assemble_bits, *bits, *bitsLen32);
+        MEMCPY(m_assemble_bits, kernelBits, bitsLen);
         *bits = m_assemble_bits;
+        *bitsLen32 = (uint32_t)bitsLen;
         delete kernel;
         return translateDiagnostics(errHandler);
     }
@@ -371,7 +387,7 @@ public:
         const iga_disassemble_options_t &dopts,
         const char *(*formatLabel)(int32_t, void *),
         void *formatLabelEnv
-    )
+    ) const
     {
         FormatOpts fopts(
             m_model.platform,
@@ -396,7 +412,7 @@ public:
 
     void checkForLegacyFields(
         iga_disassemble_options_t &dopts,
-        iga::ErrorHandler &errHandler)
+        iga::ErrorHandler &errHandler) const
     {
         // crude compatibility for legacy fields
         bool used_legacy_fields = false;
@@ -421,7 +437,7 @@ public:
         iga_disassemble_options_t &dopts,
         const void *bits,
         uint32_t bitsLen,
-        Kernel *&k)
+        Kernel *&k) const
     {
         k = nullptr;
         checkForLegacyFields(dopts, errHandler);
@@ -443,22 +459,20 @@ public:
         return k == nullptr ? IGA_DECODE_ERROR : IGA_SUCCESS;
     }
 
-    iga_status_t disassemble(
+    // Decodes a kernel and formats it into 'os' without touching any
+    // context state; so this may run concurrently.  Returns the decoding
+    // status; errors are left in 'errHandler'.
+    iga_status_t disassembleTo(
+        iga::ErrorHandler &errHandler,
         iga_disassemble_options_t &dopts,
         const void *bits,
         uint32_t bitsLen,
         const char *(*formatLbl)(int32_t, void *),
         void *formatLblEnv,
-        char **output)
+        std::ostream &os) const
     {
-        if (output)
-            *output = &m_empty_string[0];
-
         iga::Kernel *k = nullptr;
-        iga::ErrorHandler errHandler;
-        iga_status_t st = IGA_ERROR;
-
-        st = disassembleKernel(
+        iga_status_t st = disassembleKernel(
             errHandler,
             dopts,
             bits,
@@ -466,15 +480,41 @@ public:
             k);
         if (k != nullptr) {
             // we succeeded in decoding; now format the output to text
-            std::stringstream ss;
             FormatOpts fopts = formatterOpts(dopts, formatLbl, formatLblEnv);
             DepAnalysis la;
             if (dopts.formatting_opts & IGA_FORMATTING_OPT_PRINT_DEPS) {
                 la = ComputeDepAnalysis(k);
                 fopts.liveAnalysis = &la;
             }
-            FormatKernel(errHandler, ss, fopts, *k, bits);
+            FormatKernel(errHandler, os, fopts, *k, bits);
+            delete k;
+        } // k non-null
+        return st;
+    }
+
 
+    iga_status_t disassemble(
+        iga_disassemble_options_t &dopts,
+        const void *bits,
+        uint32_t bitsLen,
+        const char *(*formatLbl)(int32_t, void *),
+        void *formatLblEnv,
+        char **output)
+    {
+        if (output)
+            *output = &m_empty_string[0];
+
+        iga::ErrorHandler errHandler;
+        std::stringstream ss;
+        iga_status_t st = disassembleTo(
+            errHandler,
+            dopts,
+            bits,
+            bitsLen,
+            formatLbl,
+            formatLblEnv,
+            ss);
+        if (st != IGA_UNSUPPORTED_PLATFORM) {
             // copy the text out
             if (m_disassemble_text) {
                 // previous disassemble clobbers new disassemble
@@ -484,7 +524,6 @@ public:
             m_disassemble_text = (char *)malloc(1 + slen);
             if (!m_disassemble_text) {
                 // bail out
-                delete k;
                 return IGA_OUT_OF_MEM;
             }
             ss.read(m_disassemble_text, slen);
@@ -492,9 +531,7 @@ public:
             if(output) {
                 *output = m_disassemble_text;
             }
-
-            delete k;
-        } // k non-null
+        }
 
         st = translateDiagnostics(errHandler);
         if (errHandler.hasErrors()) {
@@ -789,6 +826,289 @@ iga_status_t  iga_context_disassemble_instruction(
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// REENTRANT API
+//
+// These share only the (read-only) model with the context; output and
+// diagnostics go straight to the caller.
+///////////////////////////////////////////////////////////////////////////////
+
+// formats directly into the caller's buffer; output that doesn't fit is
+// only counted
+class BufferStreamBuf : public std::streambuf {
+    size_t m_overflow;
+public:
+    BufferStreamBuf(char *buf, size_t bufLen) : m_overflow(0) {
+        setp(buf, buf + bufLen);
+    }
+    size_t length() const {
+        return (size_t)(pptr() - pbase()) + m_overflow;
+    }
+protected:
+    virtual std::streamsize xsputn(const char *s, std::streamsize n) {
+        std::streamsize fits = std::min<std::streamsize>(n, epptr() - pptr());
+        if (fits > 0) {
+            MEMCPY(pptr(), s, (size_t)fits);
+            pbump((int)fits);
+        }
+        m_overflow += (size_t)(n - fits);
+        return n;
+    }
+    virtual int_type overflow(int_type ch) {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            m_overflow++;
+        }
+        return traits_type::not_eof(ch);
+    }
+    // the formatter pads columns via tellp(); answer position queries only
+    virtual pos_type seekoff(
+        off_type off, std::ios_base::seekdir dir, std::ios_base::openmode)
+    {
+        if (off != 0 || dir != std::ios_base::cur)
+            return pos_type(off_type(-1));
+        return pos_type((off_type)length());
+    }
+};
+
+// hands the output to the caller's callback in chunks
+class CallbackStreamBuf : public std::streambuf {
+    iga_write_callback_t m_write;
+    void *m_writeEnv;
+    size_t m_written; // bytes already handed to the callback
+    char m_chunk[4096];
+public:
+    CallbackStreamBuf(iga_write_callback_t write, void *writeEnv)
+        : m_write(write), m_writeEnv(writeEnv), m_written(0)
+    {
+        setp(m_chunk, m_chunk + sizeof(m_chunk));
+    }
+protected:
+    virtual int sync() {
+        if (pptr() != pbase()) {
+            m_write(pbase(), (size_t)(pptr() - pbase()), m_writeEnv);
+            m_written += (size_t)(pptr() - pbase());
+            setp(m_chunk, m_chunk + sizeof(m_chunk));
+        }
+        return 0;
+    }
+    virtual std::streamsize xsputn(const char *s, std::streamsize n) {
+        if (n > epptr() - pptr()) {
+            // large writes bypass the chunk
+            sync();
+            if (n >= (std::streamsize)sizeof(m_chunk)) {
+                m_write(s, (size_t)n, m_writeEnv);
+                m_written += (size_t)n;
+                return n;
+            }
+        }
+        MEMCPY(pptr(), s, (size_t)n);
+        pbump((int)n);
+        return n;
+    }
+    virtual int_type overflow(int_type ch) {
+        sync();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+    virtual pos_type seekoff(
+        off_type off, std::ios_base::seekdir dir, std::ios_base::openmode)
+    {
+        if (off != 0 || dir != std::ios_base::cur)
+            return pos_type(off_type(-1));
+        return pos_type((off_type)(m_written + (size_t)(pptr() - pbase())));
+    }
+};
+
+static void reportDiagnostics(
+    const iga::ErrorHandler &errHandler,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnosticEnv)
+{
+    if (diagnostic == nullptr) {
+        return;
+    }
+    auto report = [&] (const std::vector<iga::Diagnostic> &ds, int isError) {
+        for (const auto &d : ds) {
+            iga_diagnostic_t temp =
+                {0, 0, (uint32_t)d.at.offset, d.at.extent, d.message.c_str()};
+            if (d.at.col != 0 && d.at.line != 0) {
+                temp.line = d.at.line;
+                temp.column = d.at.col;
+            }
+            diagnostic(&temp, isError, diagnosticEnv);
+        }
+    };
+    report(errHandler.getErrors(), 1);
+    report(errHandler.getWarnings(), 0);
+}
+
+static iga_status_t assembleReentrant(
+    iga_context_t ctx,
+    const iga_assemble_options_t *aopts,
+    const char *kernel_text,
+    const std::function<void(const void *, size_t)> &output,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env)
+{
+    RETURN_INVALID_ARG_ON_NULL(ctx);
+    RETURN_INVALID_ARG_ON_NULL(aopts);
+    RETURN_INVALID_ARG_ON_NULL(kernel_text);
+    // see note at the top of the file about binary compatibility
+    if (aopts->cb > sizeof(*aopts)) {
+        return IGA_VERSION_ERROR;
+    }
+    iga_assemble_options_t aoptsInternal = IGA_ASSEMBLE_OPTIONS_INIT();
+    MEMCPY(&aoptsInternal, aopts, aopts->cb);
+
+    CAST_CONTEXT(ctx_obj, ctx);
+    iga::ErrorHandler errHandler;
+    Kernel *kernel = nullptr;
+    void *bits = nullptr;
+    size_t bitsLen = 0;
+    iga_status_t st = ctx_obj->assembleKernel(
+        errHandler, aoptsInternal, kernel_text, kernel, bits, bitsLen);
+    if (st == IGA_SUCCESS) {
+        output(bits, bitsLen);
+    }
+    delete kernel;
+    reportDiagnostics(errHandler, diagnostic, diagnostic_env);
+    return st;
+}
+
+static iga_status_t disassembleReentrant(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *dopts,
+    const void *input,
+    uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *),
+    void *fmt_label_ctx,
+    std::streambuf &output,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env)
+{
+    RETURN_INVALID_ARG_ON_NULL(ctx);
+    RETURN_INVALID_ARG_ON_NULL(dopts);
+    RETURN_INVALID_ARG_ON_NULL(input || input_size == 0);
+    // see note at the top of the file about binary compatibility
+    if (dopts->cb > sizeof(*dopts)) {
+        return IGA_VERSION_ERROR;
+    }
+    iga_disassemble_options_t doptsInternal = IGA_DISASSEMBLE_OPTIONS_INIT();
+    MEMCPY(&doptsInternal, dopts, dopts->cb);
+
+    CAST_CONTEXT(ctx_obj, ctx);
+    iga::ErrorHandler errHandler;
+    std::ostream os(&output);
+    iga_status_t st = ctx_obj->disassembleTo(
+        errHandler,
+        doptsInternal,
+        input,
+        input_size,
+        fmt_label_name,
+        fmt_label_ctx,
+        os);
+    os.flush();
+    reportDiagnostics(errHandler, diagnostic, diagnostic_env);
+    if (errHandler.hasErrors()) {
+        return IGA_DECODE_ERROR;
+    }
+    return st == IGA_UNSUPPORTED_PLATFORM ? st : IGA_SUCCESS;
+}
+
+iga_status_t  iga_context_assemble_to_buffer(
+    iga_context_t ctx,
+    const iga_assemble_options_t *opts,
+    const char *kernel_text,
+    void *output,
+    size_t output_size,
+    size_t *output_size_required,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env)
+{
+    RETURN_INVALID_ARG_ON_NULL(output || output_size == 0);
+    RETURN_INVALID_ARG_ON_NULL(output_size_required);
+
+    *output_size_required = 0;
+    return assembleReentrant(ctx, opts, kernel_text,
+        [&] (const void *bits, size_t bitsLen) {
+            MEMCPY(output, bits, std::min(bitsLen, output_size));
+            *output_size_required = bitsLen;
+        },
+        diagnostic, diagnostic_env);
+}
+
+iga_status_t  iga_context_assemble_to_callback(
+    iga_context_t ctx,
+    const iga_assemble_options_t *opts,
+    const char *kernel_text,
+    iga_write_callback_t write,
+    void *write_env,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env)
+{
+    RETURN_INVALID_ARG_ON_NULL(write);
+
+    return assembleReentrant(ctx, opts, kernel_text,
+        [&] (const void *bits, size_t bitsLen) {
+            write(bits, bitsLen, write_env);
+        },
+        diagnostic, diagnostic_env);
+}
+
+iga_status_t  iga_context_disassemble_to_buffer(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *dopts,
+    const void *input,
+    uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *),
+    void *fmt_label_ctx,
+    char *kernel_text,
+    size_t kernel_text_size,
+    size_t *kernel_text_size_required,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env)
+{
+    RETURN_INVALID_ARG_ON_NULL(kernel_text || kernel_text_size == 0);
+    RETURN_INVALID_ARG_ON_NULL(kernel_text_size_required);
+
+    // reserve the last byte for the NUL
+    BufferStreamBuf buf(
+        kernel_text, kernel_text_size == 0 ? 0 : kernel_text_size - 1);
+    iga_status_t st = disassembleReentrant(
+        ctx, dopts, input, input_size, fmt_label_name, fmt_label_ctx,
+        buf, diagnostic, diagnostic_env);
+    size_t len = buf.length();
+    if (kernel_text_size != 0) {
+        kernel_text[std::min(len, kernel_text_size - 1)] = 0;
+    }
+    *kernel_text_size_required = len + 1;
+    return st;
+}
+
+iga_status_t  iga_context_disassemble_to_callback(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *dopts,
+    const void *input,
+    uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *),
+    void *fmt_label_ctx,
+    iga_write_callback_t write,
+    void *write_env,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env)
+{
+    RETURN_INVALID_ARG_ON_NULL(write);
+
+    CallbackStreamBuf buf(write, write_env);
+    return disassembleReentrant(
+        ctx, dopts, input, input_size, fmt_label_name, fmt_label_ctx,
+        buf, diagnostic, diagnostic_env);
+}
+
+
 iga_status_t iga_context_get_errors(
     iga_context_t ctx,
     const iga_diagnostic_t **ds,
@@ -570,6 +570,138 @@ IGA_API iga_status_t iga_get_warnings(
     uint32_t *ds_len);
 
 
+/*
+ * REENTRANT API
+ *
+ * The calls below are variants of 'iga_context_assemble' and
+ * 'iga_context_disassemble' that hand their output to the caller directly
+ * (in a caller-provided buffer or through a callback) and report diagnostics
+ * through a callback.  They never touch the context's cached output or
+ * diagnostics; hence, 'iga_context_get_errors' and
+ * 'iga_context_get_warnings' do not reflect them.  The only state they share
+ * is the read-only platform model, so any number of threads may call them
+ * concurrently on the same context.  (The context must not be released
+ * while a call is in progress.)
+ */
+
+/*
+ * Receives output from the reentrant calls, possibly in several pieces.
+ * The data is only valid for the duration of the callback.  Text is not
+ * NUL-terminated.
+ */
+typedef void (*iga_write_callback_t)(
+    const void *data,
+    size_t data_len,
+    void *env);
+
+/*
+ * Receives a diagnostic from the reentrant calls.  'is_error' is non-zero
+ * for errors and zero for warnings.  The diagnostic (including its message)
+ * is only valid for the duration of the callback.
+ */
+typedef void (*iga_diagnostic_callback_t)(
+    const iga_diagnostic_t *d,
+    int is_error,
+    void *env);
+
+/*
+ * Reentrant variant of 'iga_context_assemble' that writes the bits into a
+ * caller-provided buffer.
+ *
+ * PARAMETERS:
+ *  ctx                   the iga context
+ *  opts                  the assemble options
+ *  kernel_text           a NUL-terminated string containing the kernel text
+ *  output                the caller's buffer (can be NULL if output_size
+ *                        is 0); if it is too small, only a prefix of the
+ *                        bits is written
+ *  output_size           the size of 'output' in bytes
+ *  output_size_required  assigned the size of the assembled bits
+ *                        (0 upon failure)
+ *  diagnostic            an optional callback for errors and warnings
+ *  diagnostic_env        forwarded to 'diagnostic'
+ *
+ * RETURNS:
+ *  the same values as 'iga_context_assemble'
+ */
+IGA_API iga_status_t  iga_context_assemble_to_buffer(
+    iga_context_t ctx,
+    const iga_assemble_options_t *opts,
+    const char *kernel_text,
+    void *output,
+    size_t output_size,
+    size_t *output_size_required,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+
+/*
+ * Reentrant variant of 'iga_context_assemble' that passes the bits to a
+ * callback (only upon success).  Parameters and return values are as in
+ * 'iga_context_assemble_to_buffer'.
+ */
+IGA_API iga_status_t  iga_context_assemble_to_callback(
+    iga_context_t ctx,
+    const iga_assemble_options_t *opts,
+    const char *kernel_text,
+    iga_write_callback_t write,
+    void *write_env,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+
+/*
+ * Reentrant variant of 'iga_context_disassemble' that formats the text
+ * directly into a caller-provided buffer.
+ *
+ * PARAMETERS:
+ *  ctx, opts, input, input_size, fmt_label_name, fmt_label_ctx
+ *                        as in 'iga_context_disassemble'
+ *  kernel_text           the caller's buffer (can be NULL if
+ *                        kernel_text_size is 0); the text is always
+ *                        NUL-terminated, truncating it if needed
+ *  kernel_text_size      the size of 'kernel_text' in bytes
+ *  kernel_text_size_required
+ *                        assigned the size needed for the full text
+ *                        (including the NUL); if this exceeds
+ *                        'kernel_text_size', the text was truncated
+ *  diagnostic            an optional callback for errors and warnings
+ *  diagnostic_env        forwarded to 'diagnostic'
+ *
+ * RETURNS:
+ *  the same values as 'iga_context_disassemble' and also
+ *  IGA_UNSUPPORTED_PLATFORM if the decoder does not support the platform
+ */
+IGA_API iga_status_t  iga_context_disassemble_to_buffer(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *opts,
+    const void *input,
+    uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *),
+    void *fmt_label_ctx,
+    char *kernel_text,
+    size_t kernel_text_size,
+    size_t *kernel_text_size_required,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+
+/*
+ * Reentrant variant of 'iga_context_disassemble' that streams the text to a
+ * callback as it is formatted.  Upon a decoding error the callback may have
+ * received a partial kernel.  Return values are as in
+ * 'iga_context_disassemble_to_buffer'.
+ */
+IGA_API iga_status_t  iga_context_disassemble_to_callback(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *opts,
+    const void *input,
+    uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *),
+    void *fmt_label_ctx,
+    iga_write_callback_t write,
+    void *write_env,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+
+
 /*
  * Fetches a diagnostic's message.  The internal memory containing the message
  * should be copied out before further disassemble or assembly or context
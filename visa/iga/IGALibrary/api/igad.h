@@ -115,6 +115,52 @@ typedef iga_status_t(CDECLATTRIBUTE * pIGADisassembleInstruction)(
     void *fmt_label_ctx,
     char **kernel_text);
 
+/* reentrant variants (not in iga_functions_t to keep its layout) */
+#define IGA_CONTEXT_ASSEMBLE_TO_BUFFER_STR "iga_context_assemble_to_buffer"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextAssembleToBuffer)(
+    iga_context_t ctx,
+    const iga_assemble_options_t *opts,
+    const char *kernel_text,
+    void *output,
+    size_t output_size,
+    size_t *output_size_required,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+#define IGA_CONTEXT_ASSEMBLE_TO_CALLBACK_STR "iga_context_assemble_to_callback"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextAssembleToCallback)(
+    iga_context_t ctx,
+    const iga_assemble_options_t *opts,
+    const char *kernel_text,
+    iga_write_callback_t write,
+    void *write_env,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+#define IGA_CONTEXT_DISASSEMBLE_TO_BUFFER_STR "iga_context_disassemble_to_buffer"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextDisassembleToBuffer)(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *opts,
+    const void *input,
+    uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *),
+    void *fmt_label_ctx,
+    char *kernel_text,
+    size_t kernel_text_size,
+    size_t *kernel_text_size_required,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+#define IGA_CONTEXT_DISASSEMBLE_TO_CALLBACK_STR "iga_context_disassemble_to_callback"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextDisassembleToCallback)(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *opts,
+    const void *input,
+    uint32_t input_size,
+    const char *(*fmt_label_name)(int32_t, void *),
+    void *fmt_label_ctx,
+    iga_write_callback_t write,
+    void *write_env,
+    iga_diagnostic_callback_t diagnostic,
+    void *diagnostic_env);
+
 #define IGA_CONTEXT_GET_ERRORS_STR "iga_context_get_errors"
 typedef iga_status_t(CDECLATTRIBUTE * pIGAContextGetErrors)(
     iga_context_t ctx,
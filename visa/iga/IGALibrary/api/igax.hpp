@@ -298,39 +298,59 @@ inline Context::~Context() {
     context = nullptr;
 }
 
+// the wrappers use the reentrant API; hence, a Context may be shared
+// between threads
+struct CallbackDiagnostics {
+    std::vector<Diagnostic> errors, warnings;
+
+    static void collect(const iga_diagnostic_t *d, int isError, void *env) {
+        CallbackDiagnostics *ds = (CallbackDiagnostics *)env;
+        std::vector<Diagnostic> &to = isError ? ds->errors : ds->warnings;
+        iga_diagnostic_type_t dt = IGA_DIAGNOSTIC_TEXT;
+        (void)iga_diagnostic_get_type(d, &dt);
+        if (dt == IGA_DIAGNOSTIC_TEXT) {
+            to.emplace_back(d->message,
+                (int)d->line, (int)d->column, (int)d->offset, (int)d->extent);
+        } else { // binary
+            to.emplace_back(d->message, 0, 0, (int)d->offset, 0);
+        }
+    }
+};
+
+template <typename T>
+static void appendOutput(const void *data, size_t dataLen, void *env)
+{
+    T *out = (T *)env;
+    const auto *chars = (const typename T::value_type *)data;
+    out->insert(out->end(), chars, chars + dataLen);
+}
+
 inline AsmResult Context::assembleFromString(
     const std::string &text,
     const iga_assemble_options_t &opts)
 {
     AsmResult result;
-    void *bits;
-    uint32_t bitsLen;
+    CallbackDiagnostics ds;
 
-    iga_status_t st =
-        iga_assemble(context, &opts, text.c_str(), &bits, &bitsLen);
+    iga_status_t st = iga_context_assemble_to_callback(
+        context,
+        &opts,
+        text.c_str(),
+        &appendOutput<Bits>,
+        &result.value,
+        &CallbackDiagnostics::collect,
+        &ds);
     if (st != IGA_SUCCESS) {
-        if (st == IGA_UNSUPPORTED_PLATFORM) {
-            std::vector<Diagnostic> errs;
-            throw AssembleError(st, "iga_assemble", errs, text);
-        }
-        std::vector<Diagnostic> errs = igax::getErrors(context);
         if (st == IGA_PARSE_ERROR) {
-            throw SyntaxError("iga_assemble", errs, text);
+            throw SyntaxError("iga_assemble", ds.errors, text);
         } else if (st == IGA_ENCODE_ERROR) {
-            throw EncodeError("iga_assemble", errs, text);
+            throw EncodeError("iga_assemble", ds.errors, text);
         } else {
-            throw AssembleError(st, "iga_assemble", errs, text);
+            throw AssembleError(st, "iga_assemble", ds.errors, text);
         }
     }
 
-    // copy out the warnings
-    result.warnings = igax::getWarnings(context);
-    // copy out the bits
-    if (bitsLen > 0) {
-        result.value.resize(bitsLen);
-        IGA_MEMCPY(result.value.data(), bits, bitsLen);
-    }
-
+    result.warnings = ds.warnings;
     return result;
 }
 
@@ -339,31 +359,29 @@ inline DisResult Context::disassembleToString(
     const size_t bitsLen,
     const iga_disassemble_options_t &opts)
 {
-    char *text;
-    iga_status_t st = iga_disassemble(
+    DisResult result;
+    CallbackDiagnostics ds;
+
+    iga_status_t st = iga_context_disassemble_to_callback(
         context,
         &opts,
         bits,
         (uint32_t)bitsLen,
         nullptr,
         nullptr,
-        &text);
+        &appendOutput<std::string>,
+        &result.value,
+        &CallbackDiagnostics::collect,
+        &ds);
     if (st != IGA_SUCCESS) {
-        if (st == IGA_UNSUPPORTED_PLATFORM) {
-            std::vector<Diagnostic> errs;
-            throw DisassembleError(st, "iga_disassemble", errs, bits, bitsLen);
-        }
-        std::vector<Diagnostic> errs = igax::getErrors(context);
         if (st == IGA_DECODE_ERROR) {
-            throw DecodeError("iga_disassemble", errs, bits, bitsLen);
+            throw DecodeError("iga_disassemble", ds.errors, bits, bitsLen);
         } else {
-            throw DisassembleError(st, "iga_disassemble", errs, bits, bitsLen);
+            throw DisassembleError(st, "iga_disassemble", ds.errors, bits, bitsLen);
         }
     }
 
-    DisResult result;
-    result.value = text;
-    result.warnings = getWarnings(context);
+    result.warnings = ds.warnings;
     return result;
 }
 
@@ -196,6 +196,118 @@ void kv_delete(kv_t *kv)
 }
 
 
+class KernelStreamImpl {
+private:
+    KernelStreamImpl(const KernelStreamImpl&);
+    KernelStreamImpl& operator =(const KernelStreamImpl &);
+public:
+    iga::ErrorHandler                       m_errHandler;
+    iga::Decoder                            m_decoder;
+    const iga::Instruction                 *m_inst;
+    bool                                    m_done;
+
+    KernelStreamImpl(
+        iga::Platform platf,
+        const void *bytes,
+        size_t bytesLength)
+        : m_decoder(*Model::LookupModel(platf), m_errHandler)
+        , m_inst(nullptr)
+        , m_done(false)
+    {
+        m_decoder.beginStream(bytes, bytesLength);
+    }
+
+    ~KernelStreamImpl() {
+        m_decoder.endStream();
+    }
+};
+
+
+kv_stream_t *kv_stream_create(
+    iga_gen_t gen_platf,
+    const void *bytes,
+    size_t bytes_len,
+    iga_status_t *status)
+{
+    iga::Platform p = ToPlatform(gen_platf);
+    if (p == iga::Platform::INVALID) {
+        if (status)
+            *status = IGA_UNSUPPORTED_PLATFORM;
+        return nullptr;
+    }
+
+    KernelStreamImpl *kvsImpl =
+        new (std::nothrow)KernelStreamImpl(p, bytes, bytes_len);
+    if (status)
+        *status = kvsImpl ? IGA_SUCCESS : IGA_OUT_OF_MEM;
+    return (kv_stream_t *)kvsImpl;
+}
+
+
+void kv_stream_delete(kv_stream_t *kvs)
+{
+    if (kvs)
+        delete ((KernelStreamImpl *)kvs);
+}
+
+
+int32_t kv_stream_next(kv_stream_t *kvs)
+{
+    if (!kvs)
+        return KV_INVALID_PC_VALUE;
+
+    KernelStreamImpl *kvsImpl = (KernelStreamImpl *)kvs;
+    kvsImpl->m_inst = nullptr;
+    if (kvsImpl->m_done) {
+        return KV_INVALID_PC_VALUE;
+    }
+    try {
+        kvsImpl->m_inst = kvsImpl->m_decoder.decodeNextStreamed();
+    } catch (const iga::FatalError &) {
+        // the error is already logged; end the stream here
+    }
+    if (!kvsImpl->m_inst) {
+        kvsImpl->m_done = true;
+        return KV_INVALID_PC_VALUE;
+    }
+    return kvsImpl->m_inst->getPC();
+}
+
+
+int32_t kv_stream_get_inst_size(const kv_stream_t *kvs)
+{
+    if (!kvs)
+        return 0;
+
+    const iga::Instruction *inst = ((const KernelStreamImpl *)kvs)->m_inst;
+    if (!inst) {
+        return 0;
+    }
+    return inst->hasInstOpt(iga::InstOpt::COMPACTED) ? 8 : 16;
+}
+
+
+uint32_t kv_stream_get_opcode(const kv_stream_t *kvs)
+{
+    if (!kvs) {
+        return static_cast<uint32_t>(Op::INVALID);
+    }
+    const iga::Instruction *inst = ((const KernelStreamImpl *)kvs)->m_inst;
+    if (!inst) {
+        return static_cast<uint32_t>(Op::INVALID);
+    }
+    return static_cast<uint32_t>(inst->getOpSpec().op);
+}
+
+
+uint32_t kv_stream_has_errors(const kv_stream_t *kvs)
+{
+    if (!kvs)
+        return 0;
+    return ((const KernelStreamImpl *)kvs)->m_errHandler.hasErrors() ? 1 : 0;
+}
+
+
 int32_t kv_get_inst_size(const kv_t *kv, int32_t pc)
 {
     if (!kv)
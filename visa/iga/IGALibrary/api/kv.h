@@ -102,6 +102,60 @@ IGA_API kv_t *kv_create(
 IGA_API void kv_delete(kv_t *);
 
 
+/* incomplete type for a streaming decoder handle */
+struct kv_stream_t;
+
+/*
+ * Creates a streaming decoder over a kernel binary.  Unlike kv_create, this
+ * does not build the whole kernel; kv_stream_next decodes one instruction
+ * per call into storage that the following call reuses, so memory use does
+ * not grow with the binary.  This suits single pass scans of large binaries
+ * (e.g. statistics).  Labels are not resolved.
+ *   'plat' - the platform
+ *   'bytes' - the kernel binary (must outlive the stream)
+ *   'bytes_len' - the length of 'bytes'
+ *   'status' - the IGA status code (can pass nullptr)
+ * RETURNS: a stream for use in other kv_stream_* functions or nullptr
+ *  on failure.  Deallocate it with kv_stream_delete.
+ */
+IGA_API kv_stream_t *kv_stream_create(
+    iga_gen_t plat,
+    const void *bytes,
+    size_t bytes_len,
+    iga_status_t *status);
+
+/* destroys a streaming decoder */
+IGA_API void kv_stream_delete(kv_stream_t *);
+
+/*
+ * Decodes the next instruction and returns its PC; returns
+ * KV_INVALID_PC_VALUE once the binary is exhausted.  The kv_stream_get_*
+ * functions refer to this instruction until the next call.  For example:
+ *
+ *   while (kv_stream_next(kvs) != KV_INVALID_PC_VALUE) {
+ *     uint32_t op = kv_stream_get_opcode(kvs);
+ *     ...
+ *   }
+ */
+IGA_API int32_t kv_stream_next(kv_stream_t *kvs);
+
+/*
+ * Returns the size of the current instruction; returns 0 if there is none.
+ */
+IGA_API int32_t kv_stream_get_inst_size(const kv_stream_t *kvs);
+
+/*
+ * Returns the opcode of the current instruction with the same encoding as
+ * kv_get_opcode.
+ */
+IGA_API uint32_t kv_stream_get_opcode(const kv_stream_t *kvs);
+
+/*
+ * Returns non-zero if any instruction decoded so far had a decode error.
+ */
+IGA_API uint32_t kv_stream_has_errors(const kv_stream_t *kvs);
+
+
 /*
 * Returns the size of the instruction at 'pc'; returns 0 if the program
 * address is out of bounds.  This allows one to iterate a kernel using this
@@ -0,0 +1,123 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+// Checks that the streaming decoder (kv_stream_*) visits the same
+// instructions as the whole kernel decoder behind kv_create.
+#include "api/iga.h"
+#include "api/kv.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+static const char *KERNEL_TEXT =
+    "        mov (8|M0)     r10.0<1>:ud   r0.0<8;8,1>:ud\n"
+    "        add (16|M0)    r12.0<1>:f    r14.0<8;8,1>:f  r16.0<8;8,1>:f\n"
+    "LOOP:\n"
+    "        mul (8|M0)     r20.0<1>:f    r20.0<8;8,1>:f  r22.0<8;8,1>:f\n"
+    "        cmp (8|M0)     (lt)f0.0  null<1>:d   r24.0<8;8,1>:d  0x10:d\n"
+    "        add (8|M0)     r24.0<1>:d    r24.0<8;8,1>:d  0x1:d\n"
+    "(f0.0)  while (8|M0)   LOOP\n"
+    "        mad (8|M0)     r26.0<1>:f    r26.0<4;1>:f    r28.0<4;1>:f    r30.0<1>:f\n"
+    "        mov (8|M0)     r127.0<1>:ud  r0.0<8;8,1>:ud\n"
+    "        send (8|M0)    null:ud  r127:ud  0x27  0x02000010 {EOT}\n";
+
+static int s_failures = 0;
+
+static void check(bool cond, const char *what, int32_t pc)
+{
+    if (!cond) {
+        fprintf(stderr, "FAIL: PC 0x%X: %s\n", (unsigned)pc, what);
+        s_failures++;
+    }
+}
+
+static void compareDecoders(const void *bits, uint32_t bitsLen)
+{
+    iga_status_t st = IGA_SUCCESS;
+    kv_t *kv = kv_create(IGA_GEN9, bits, bitsLen, &st, nullptr, 0);
+    check(kv != nullptr && st == IGA_SUCCESS, "kv_create failed", 0);
+    kv_stream_t *kvs = kv_stream_create(IGA_GEN9, bits, bitsLen, &st);
+    check(kvs != nullptr && st == IGA_SUCCESS, "kv_stream_create failed", 0);
+    if (!kv || !kvs) {
+        kv_delete(kv);
+        kv_stream_delete(kvs);
+        return;
+    }
+
+    int32_t pc = 0, iLen = 0, numInsts = 0, numCompacted = 0;
+    for (; (iLen = kv_get_inst_size(kv, pc)) != 0; pc += iLen) {
+        int32_t streamPc = kv_stream_next(kvs);
+        check(streamPc == pc, "stream PC differs", pc);
+        check(kv_stream_get_inst_size(kvs) == iLen,
+            "stream instruction size differs", pc);
+        check(kv_stream_get_opcode(kvs) == kv_get_opcode(kv, pc),
+            "stream opcode differs", pc);
+        numInsts++;
+        if (iLen == 8)
+            numCompacted++;
+    }
+    check(kv_stream_next(kvs) == KV_INVALID_PC_VALUE,
+        "stream has extra instructions", pc);
+    check(kv_stream_next(kvs) == KV_INVALID_PC_VALUE,
+        "stream restarted after the end", pc);
+    check(kv_stream_has_errors(kvs) == 0, "stream reported errors", pc);
+    check(numInsts == 9, "unexpected instruction count", pc);
+    check(numCompacted > 0, "expected some compacted instructions", pc);
+
+    kv_stream_delete(kvs);
+    kv_delete(kv);
+}
+
+int main(int argc, const char **argv)
+{
+    iga_context_options_t ctxOpts = IGA_CONTEXT_OPTIONS_INIT(IGA_GEN9);
+    iga_context_t ctx;
+    if (iga_context_create(&ctxOpts, &ctx) != IGA_SUCCESS) {
+        fprintf(stderr, "FAIL: iga_context_create\n");
+        return EXIT_FAILURE;
+    }
+
+    iga_assemble_options_t asmOpts = IGA_ASSEMBLE_OPTIONS_INIT();
+    asmOpts.encoder_opts |= IGA_ENCODER_OPT_AUTO_COMPACT;
+    void *bits = nullptr;
+    uint32_t bitsLen = 0;
+    if (iga_context_assemble(
+        ctx, &asmOpts, KERNEL_TEXT, &bits, &bitsLen) != IGA_SUCCESS)
+    {
+        fprintf(stderr, "FAIL: iga_context_assemble\n");
+        iga_context_release(ctx);
+        return EXIT_FAILURE;
+    }
+
+    compareDecoders(bits, bitsLen);
+
+    iga_context_release(ctx);
+    if (s_failures) {
+        fprintf(stderr, "%d failure(s)\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("PASSED\n");
+    return EXIT_SUCCESS;
+}
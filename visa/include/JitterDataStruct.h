@@ -76,6 +76,10 @@ typedef struct _CM_JIT_INFO {
     unsigned char numBytesScratchGtpin;
 
     uint32_t offsetToSkipPerThreadDataLoad = 0; 
+
+    // spill memory the kernel would need if spilled ranges did not share
+    // slots; compare with spillMemUsed
+    unsigned int spillMemUnshared = 0;
 } FINALIZER_INFO;
 
 #endif // _CM_JITTERDATASTRUCT_
@@ -820,6 +820,10 @@ public:
 
     // For inline asm code generation
     CM_BUILDER_API virtual int ParseVISAText(const std::string& visaHeader, const std::string& visaText, const std::string& visaTextFile) = 0;
+    // Parse a vISA text snippet and append it to KERNEL, which may be built
+    // through the API. The snippet refers to the kernel's variables by their
+    // default names (see VISAKernel::getVarName()).
+    CM_BUILDER_API virtual int ParseInlineVISAText(VISAKernel* kernel, const std::string& visaText) = 0;
     CM_BUILDER_API virtual int WriteVISAHeader() = 0;
     CM_BUILDER_API virtual std::stringstream& GetAsmTextStream() = 0;
     CM_BUILDER_API virtual std::stringstream& GetAsmTextHeaderStream() = 0;